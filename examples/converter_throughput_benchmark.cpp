@@ -0,0 +1,86 @@
+/**
+ * @file converter_throughput_benchmark.cpp
+ * @brief Conversion throughput of convertXadTapeToForge on large tapes
+ *
+ * Records synthetic tapes of increasing size (a mix of binary, unary and
+ * scalar opcodes over a pool of live variables, similar to a long
+ * pricing loop) and reports conversion speed in statements per second.
+ *
+ * Usage: converter_throughput_benchmark [max_statements]   (default 8M)
+ */
+
+#include "forge_xad/xad_tape_converter.hpp"
+#include <XAD/XAD.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+using mode = xad::adj<double>;
+using tape_type = mode::tape_type;
+using AD = mode::active_type;
+
+constexpr std::size_t kNumInputs = 1000;
+constexpr std::size_t kPoolSize = 64;
+
+// Records roughly numStatements statements
+void recordSyntheticTape(tape_type& tape, std::size_t numStatements) {
+    std::vector<AD> inputs(kNumInputs);
+    for (std::size_t i = 0; i < kNumInputs; ++i) {
+        value(inputs[i]) = 1.0 + 0.001 * i;
+        tape.registerInput(inputs[i]);
+    }
+    tape.newRecording();
+
+    std::vector<AD> pool(inputs.begin(), inputs.begin() + kPoolSize);
+    AD sum = inputs[0] * 0.0;
+    for (std::size_t k = 0; k < numStatements / 4; ++k) {
+        AD& a = pool[k % kPoolSize];
+        const AD& b = inputs[(k * 7) % kNumInputs];
+        a = a * b;               // binary
+        a = exp(a * 0.001);      // scalar + unary
+        sum = sum + a;           // binary
+    }
+    tape.registerOutput(sum);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t max_statements = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 8000000;
+
+    std::cout << "========================================\n";
+    std::cout << "Converter Throughput Benchmark\n";
+    std::cout << "========================================\n\n";
+    std::cout << std::setw(14) << "statements" << std::setw(12) << "nodes"
+              << std::setw(12) << "time/ms" << std::setw(16) << "stmts/sec" << "\n";
+
+    for (std::size_t target = 100000; target <= max_statements; target *= 4) {
+        tape_type tape;
+        recordSyntheticTape(tape, target);
+
+        const int reps = 3;
+        double best_ms = 0.0;
+        std::size_t nodes = 0;
+        for (int rep = 0; rep < reps; ++rep) {
+            auto start = std::chrono::high_resolution_clock::now();
+            auto result = forge_xad::convertXadTapeToForge(tape);
+            auto end = std::chrono::high_resolution_clock::now();
+            double ms = std::chrono::duration<double, std::milli>(end - start).count();
+            if (rep == 0 || ms < best_ms) {
+                best_ms = ms;
+            }
+            nodes = result.graph.nodes.size();
+        }
+
+        const double statements = static_cast<double>(tape.getNumStatements());
+        std::cout << std::setw(14) << tape.getNumStatements() << std::setw(12) << nodes
+                  << std::setw(12) << std::fixed << std::setprecision(1) << best_ms
+                  << std::setw(16) << std::setprecision(0) << statements / (best_ms * 1e-3)
+                  << std::defaultfloat << "\n";
+    }
+    return 0;
+}
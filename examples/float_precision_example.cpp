@@ -0,0 +1,220 @@
+/**
+ * @file float_precision_example.cpp
+ * @brief Accuracy and footprint of single-precision tapes and batches
+ *
+ * Forge kernels compute in double, so float support is about storage:
+ *   1. JITTape<Tape<float>> records in float and runs the double kernel;
+ *      compared against an XAD float tape and a double reference on a few
+ *      benchmark functions (relative error of value and gradient).
+ *   2. computeBatch() on float scenario arrays (half the memory of double
+ *      arrays) vs. double arrays on a Monte Carlo style batch.
+ *
+ * Usage: float_precision_example [scenarios]   (default 100003)
+ */
+
+#include "forge_xad/jit_tape.hpp"
+#include <XAD/XAD.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+constexpr int kNumInputs = 4;
+
+// Benchmark functions over (spot, rate, vol, maturity). Literals are typed
+// as the tape's scalar so the same code records in float and double
+template<class Real, class T>
+T lognormalForward(const std::vector<T>& x) {
+    const Real half = 0.5;
+    return x[0] * exp((x[1] - x[2] * x[2] * half) * x[3]);
+}
+
+template<class Real, class T>
+T discountedStrip(const std::vector<T>& x) {
+    const T rate = x[1] + x[2] * x[2];
+    T pv = exp(-rate * Real(0.25)) * x[3];
+    for (int k = 2; k <= 20; ++k) {
+        const Real t = Real(0.25) * static_cast<Real>(k);
+        pv = pv + exp(-rate * t) * (x[3] * t);
+    }
+    return pv;
+}
+
+template<class Real, class T>
+T rationalVol(const std::vector<T>& x) {
+    const Real one = 1.0;
+    const T m = log(x[0] / (x[0] * x[1] + one));
+    return sqrt(x[2] * x[2] * x[3] + m * m) / (one + x[3]);
+}
+
+const double kPoint[kNumInputs] = {100.0, 0.03, 0.25, 2.0};
+
+enum class Function { Forward, Strip, Rational };
+
+template<class Real, class T>
+T evaluate(Function f, const std::vector<T>& x) {
+    switch (f) {
+    case Function::Forward:
+        return lognormalForward<Real>(x);
+    case Function::Strip:
+        return discountedStrip<Real>(x);
+    default:
+        return rationalVol<Real>(x);
+    }
+}
+
+// Value followed by the gradient
+template<class Real, class Tape>
+std::vector<double> sweep(Tape& tape, Function f) {
+    using AD = xad::AReal<Real, 1>;
+    std::vector<AD> x(kNumInputs);
+    for (int i = 0; i < kNumInputs; ++i) {
+        x[i] = static_cast<Real>(kPoint[i]);
+        tape.registerInput(x[i]);
+    }
+    tape.newRecording();
+    AD y = evaluate<Real>(f, x);
+    tape.registerOutput(y);
+    derivative(y) = Real(1);
+    tape.computeAdjoints();
+
+    std::vector<double> result{static_cast<double>(value(y))};
+    for (auto& xi : x) {
+        result.push_back(static_cast<double>(derivative(xi)));
+    }
+    tape.clearAll();
+    return result;
+}
+
+double maxRelativeError(const std::vector<double>& a, const std::vector<double>& reference) {
+    double err = 0.0;
+    for (std::size_t k = 0; k < a.size(); ++k) {
+        err = std::max(err, std::abs(a[k] - reference[k]) / std::max(std::abs(reference[k]), 1e-12));
+    }
+    return err;
+}
+
+// Part 1: one row per benchmark function
+bool compareTapes(Function f, const std::string& name) {
+    std::vector<double> reference, xad_float, jit_float;
+    {
+        xad::Tape<double> tape;
+        reference = sweep<double>(tape, f);
+    }
+    {
+        xad::Tape<float> tape;
+        xad_float = sweep<float>(tape, f);
+    }
+    {
+        forge_xad::JITTape<xad::Tape<float>> tape;
+        sweep<float>(tape, f);                 // records and compiles
+        jit_float = sweep<float>(tape, f);     // runs on the kernel
+    }
+
+    const double xad_err = maxRelativeError(xad_float, reference);
+    const double jit_err = maxRelativeError(jit_float, reference);
+    std::cout << "  " << std::left << std::setw(18) << name << std::right
+              << "  XAD float " << std::setw(10) << xad_err
+              << "  JIT float " << std::setw(10) << jit_err << "\n";
+
+    // Both are limited by float rounding of inputs, results and constants
+    return jit_err < 1e-5;
+}
+
+// Part 2: Monte Carlo style batch on float vs. double scenario arrays
+bool compareBatches(std::size_t numScenarios) {
+    using AD = xad::AReal<double, 1>;
+    forge_xad::JITTape<xad::Tape<double>> tape;
+    {
+        std::vector<AD> x(kNumInputs);
+        for (int i = 0; i < kNumInputs; ++i) {
+            x[i] = kPoint[i];
+            tape.registerInput(x[i]);
+        }
+        tape.newRecording();
+        AD y = lognormalForward<double>(x);
+        tape.registerOutput(y);
+        derivative(y) = 1.0;
+        tape.computeAdjoints();
+    }
+
+    std::mt19937_64 rng(42);
+    std::normal_distribution<double> normal;
+    std::vector<double> inputs_d(kNumInputs * numScenarios);
+    for (std::size_t s = 0; s < numScenarios; ++s) {
+        const double shock = normal(rng);
+        inputs_d[0 * numScenarios + s] = kPoint[0] * std::exp(0.2 * shock);
+        inputs_d[1 * numScenarios + s] = kPoint[1] + 0.005 * normal(rng);
+        inputs_d[2 * numScenarios + s] = kPoint[2] * (1.0 + 0.1 * shock);
+        inputs_d[3 * numScenarios + s] = kPoint[3];
+    }
+    std::vector<float> inputs_f(inputs_d.begin(), inputs_d.end());
+
+    std::vector<double> outputs_d(numScenarios), grads_d(kNumInputs * numScenarios);
+    std::vector<float> outputs_f(numScenarios), grads_f(kNumInputs * numScenarios);
+
+    tape.computeBatch(numScenarios, inputs_d.data(), outputs_d.data(), grads_d.data());  // warm-up
+    auto t0 = Clock::now();
+    tape.computeBatch(numScenarios, inputs_d.data(), outputs_d.data(), grads_d.data());
+    const double double_ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    t0 = Clock::now();
+    tape.computeBatch(numScenarios, inputs_f.data(), outputs_f.data(), grads_f.data());
+    const double float_ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+    // Monte Carlo estimates: mean price and mean sensitivities
+    double mean_d = 0.0, mean_f = 0.0;
+    for (std::size_t s = 0; s < numScenarios; ++s) {
+        mean_d += outputs_d[s];
+        mean_f += outputs_f[s];
+    }
+    double err = std::abs(mean_f - mean_d) / std::abs(mean_d);
+    for (int i = 0; i < kNumInputs; ++i) {
+        double g_d = 0.0, g_f = 0.0;
+        for (std::size_t s = 0; s < numScenarios; ++s) {
+            g_d += grads_d[i * numScenarios + s];
+            g_f += grads_f[i * numScenarios + s];
+        }
+        err = std::max(err, std::abs(g_f - g_d) / std::max(std::abs(g_d), 1e-12));
+    }
+
+    const std::size_t scenario_doubles = (2 * kNumInputs + 1) * numScenarios;
+    std::cout << "  Scenario data:  double " << scenario_doubles * sizeof(double) / 1024 << " KiB"
+              << ", float " << scenario_doubles * sizeof(float) / 1024 << " KiB\n";
+    std::cout << "  Batch time:     double " << double_ms << " ms, float " << float_ms << " ms\n";
+    std::cout << "  Max rel. error of MC estimates (float vs. double): "
+              << std::scientific << err << std::fixed << "\n";
+    return err < 1e-5;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t numScenarios = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100003;
+
+    std::cout << "========================================\n";
+    std::cout << "Single-Precision Tapes and Batches\n";
+    std::cout << "========================================\n\n";
+
+    std::cout << "Max relative error vs. double reference (value and gradient):\n";
+    std::cout << std::scientific << std::setprecision(2);
+    bool ok = compareTapes(Function::Forward, "lognormal forward");
+    ok = compareTapes(Function::Strip, "discounted strip") && ok;
+    ok = compareTapes(Function::Rational, "rational vol") && ok;
+
+    std::cout << "\nBatch of " << numScenarios << " scenarios:\n";
+    std::cout << std::fixed << std::setprecision(3);
+    ok = compareBatches(numScenarios) && ok;
+
+    std::cout << (ok ? "\n✓ Float results within single-precision tolerance\n"
+                     : "\n✗ Float results out of tolerance\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,246 @@
+/**
+ * @file graph_interpreter_benchmark.cpp
+ * @brief Graph interpreter tier vs. XAD tape and Forge native code
+ *
+ * Mid-sized tape (a small curve of swaps) evaluated a handful of times:
+ *   - start-up: bytecode build vs. Forge compilation of the same graph
+ *   - per evaluation: XAD reverse sweep, interpreter forward + reverse,
+ *     interpreter per scenario in LANES-wide batches, Forge kernel
+ *   - JITTape with ExecutionBackend::Interpreter vs. the XAD tape
+ * Gradients of every path are compared with XAD.
+ *
+ * Usage: graph_interpreter_benchmark [reuses]   (default 8)
+ */
+
+#include "forge_xad/activity_analysis.hpp"
+#include "forge_xad/graph_interpreter.hpp"
+#include "forge_xad/graph_optimizer.hpp"
+#include "forge_xad/jit_tape.hpp"
+#include "forge_xad/xad_tape_converter.hpp"
+#include <XAD/XAD.hpp>
+#include <compiler/compiler_config.hpp>
+#include <compiler/forge_engine.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+using mode = xad::adj<double>;
+using tape_type = mode::tape_type;
+using AD = mode::active_type;
+using Clock = std::chrono::high_resolution_clock;
+
+constexpr int kNumRates = 20;
+constexpr int kNumSwaps = 30;
+constexpr int kNumPeriods = 40;
+
+// Sum of swap PVs off a piecewise curve
+template<typename T>
+T curvePortfolio(const std::vector<T>& rates) {
+    T total = rates[0] * 0.0001;
+    for (int s = 0; s < kNumSwaps; ++s) {
+        const double strike = 0.02 + 0.0005 * s;
+        T df = exp(-rates[s % kNumRates] * 0.25);
+        T pv = df * (rates[s % kNumRates] - strike) * 0.25;
+        for (int p = 1; p < kNumPeriods; ++p) {
+            const T& r = rates[(s + p) % kNumRates];
+            df = df * exp(-r * 0.25);
+            pv = pv + df * (r - strike) * 0.25;
+        }
+        total = total + pv * (1.0 + 0.01 * s);
+    }
+    return total;
+}
+
+double rateValue(int reuse, int i) {
+    return 0.02 + 0.001 * i + 0.0001 * reuse;
+}
+
+// Gradient for one reuse, recorded afresh on an XAD tape or a JITTape
+template<class Tape>
+std::vector<double> recordAndSweep(Tape& tape, int reuse) {
+    std::vector<AD> x(kNumRates);
+    for (int i = 0; i < kNumRates; ++i) {
+        x[i] = rateValue(reuse, i);
+        tape.registerInput(x[i]);
+    }
+    tape.newRecording();
+    AD y = curvePortfolio(x);
+    tape.registerOutput(y);
+    derivative(y) = 1.0;
+    tape.computeAdjoints();
+    std::vector<double> gradient(kNumRates);
+    for (int i = 0; i < kNumRates; ++i) {
+        gradient[i] = derivative(x[i]);
+    }
+    tape.clearAll();
+    return gradient;
+}
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+double maxError(const std::vector<double>& a, const std::vector<double>& b) {
+    double err = 0.0;
+    for (std::size_t k = 0; k < a.size(); ++k) {
+        err = std::max(err, std::abs(a[k] - b[k]) / std::max(1.0, std::abs(b[k])));
+    }
+    return err;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int reuses = argc > 1 ? std::atoi(argv[1]) : 8;
+    constexpr int kRepeat = 50;  // timing repetitions per measurement
+
+    std::cout << "========================================\n";
+    std::cout << "Graph Interpreter Benchmark\n";
+    std::cout << "========================================\n\n";
+
+    // Record once and keep the tape for XAD reverse sweeps
+    tape_type tape;
+    std::vector<AD> rates(kNumRates);
+    for (int i = 0; i < kNumRates; ++i) {
+        rates[i] = rateValue(0, i);
+        tape.registerInput(rates[i]);
+    }
+    tape.newRecording();
+    AD pv = curvePortfolio(rates);
+    tape.registerOutput(pv);
+
+    std::vector<double> xad_gradient(kNumRates);
+    auto t0 = Clock::now();
+    for (int k = 0; k < kRepeat; ++k) {
+        tape.clearDerivatives();
+        derivative(pv) = 1.0;
+        tape.computeAdjoints();
+    }
+    const double xad_ms = msSince(t0) / kRepeat;
+    for (int i = 0; i < kNumRates; ++i) {
+        xad_gradient[i] = derivative(rates[i]);
+    }
+
+    // Shared front end: conversion, optimizer, activity analysis
+    t0 = Clock::now();
+    forge_xad::ConversionResult conversion = forge_xad::convertXadTapeToForge(tape);
+    forge_xad::optimizeGraph(conversion, forge_xad::GraphOptimizerOptions());
+    forge_xad::analyzeActivity(conversion.graph);
+    const double front_ms = msSince(t0);
+
+    t0 = Clock::now();
+    forge_xad::GraphInterpreter interpreter(conversion);
+    auto workspace = interpreter.createWorkspace();
+    const double build_ms = msSince(t0);
+
+    t0 = Clock::now();
+    forge::CompilerConfig config = forge::CompilerConfig::Default();
+    config.instructionSet = forge::CompilerConfig::InstructionSet::SSE2_SCALAR;
+    forge::ForgeEngine engine(config);
+    auto kernel = engine.compile(conversion.graph);
+    auto buffer = forge::NodeValueBufferFactory::create(conversion.graph, *kernel);
+    const double compile_ms = msSince(t0);
+
+    std::vector<double> inputs(kNumRates);
+    for (int i = 0; i < kNumRates; ++i) {
+        inputs[i] = rateValue(0, i);
+    }
+
+    // Interpreter, one input set per call
+    std::vector<double> interp_gradient(kNumRates);
+    double output = 0.0;
+    t0 = Clock::now();
+    for (int k = 0; k < kRepeat; ++k) {
+        interpreter.computeAdjoints(workspace, inputs.data(), nullptr, interp_gradient.data(), &output);
+    }
+    const double interp_ms = msSince(t0) / kRepeat;
+
+    // Interpreter, LANES scenarios per instruction
+    const std::size_t scenarios = 4 * forge_xad::GraphInterpreter::LANES;
+    std::vector<double> batch_inputs(kNumRates * scenarios), batch_outputs(scenarios),
+        batch_gradients(kNumRates * scenarios);
+    for (int i = 0; i < kNumRates; ++i) {
+        std::fill(batch_inputs.begin() + i * scenarios, batch_inputs.begin() + (i + 1) * scenarios,
+                  inputs[i]);
+    }
+    auto wide = interpreter.createWorkspace(forge_xad::GraphInterpreter::LANES);
+    t0 = Clock::now();
+    for (int k = 0; k < kRepeat; ++k) {
+        interpreter.execute(wide, scenarios, batch_inputs.data(), batch_outputs.data(),
+                            batch_gradients.data());
+    }
+    const double batch_ms = msSince(t0) / kRepeat / static_cast<double>(scenarios);
+    std::vector<double> batch_gradient(kNumRates);
+    for (int i = 0; i < kNumRates; ++i) {
+        batch_gradient[i] = batch_gradients[i * scenarios + scenarios - 1];
+    }
+
+    // Forge native kernel
+    for (int i = 0; i < kNumRates; ++i) {
+        buffer->setValue(conversion.input_nodes[i], inputs[i]);
+    }
+    t0 = Clock::now();
+    for (int k = 0; k < kRepeat; ++k) {
+        buffer->clearGradients();
+        buffer->getGradientsPtr()[conversion.output_nodes[0]] = 1.0;
+        kernel->executeDirect(buffer->getValuesPtr(), buffer->getGradientsPtr(), buffer->getNumNodes());
+    }
+    const double kernel_ms = msSince(t0) / kRepeat;
+    std::vector<double> kernel_gradient(kNumRates);
+    for (int i = 0; i < kNumRates; ++i) {
+        kernel_gradient[i] = buffer->getGradient(conversion.input_nodes[i]);
+    }
+
+    // JITTape on the interpreter backend, re-recorded per reuse as usual
+    tape.deactivate();
+    std::vector<std::vector<double>> expected(reuses);
+    {
+        tape_type reference;
+        for (int reuse = 0; reuse < reuses; ++reuse) {
+            expected[reuse] = recordAndSweep(reference, reuse);
+        }
+    }
+    double jit_err = 0.0;
+    {
+        forge_xad::JITTape<tape_type> jit;
+        jit.setExecutionBackend(forge_xad::ExecutionBackend::Interpreter);
+        for (int reuse = 0; reuse < reuses; ++reuse) {
+            jit_err = std::max(jit_err, maxError(recordAndSweep(jit, reuse), expected[reuse]));
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "Tape: " << tape.getNumStatements() << " statements, interpreter: "
+              << interpreter.numForwardInstructions() << " forward / "
+              << interpreter.numReverseInstructions() << " reverse instructions\n\n";
+    std::cout << "Start-up (after " << front_ms << " ms conversion + optimizer):\n";
+    std::cout << "  Interpreter bytecode:     " << std::setw(10) << build_ms << " ms\n";
+    std::cout << "  Forge compilation:        " << std::setw(10) << compile_ms << " ms\n";
+    std::cout << "Per evaluation:\n";
+    std::cout << "  XAD reverse sweep:        " << std::setw(10) << xad_ms << " ms\n";
+    std::cout << "  Interpreter fwd+rev:      " << std::setw(10) << interp_ms << " ms  ("
+              << xad_ms / interp_ms << "x vs XAD)\n";
+    std::cout << "  Interpreter, " << forge_xad::GraphInterpreter::LANES << " lanes:    "
+              << std::setw(10) << batch_ms << " ms  (" << xad_ms / batch_ms << "x vs XAD)\n";
+    std::cout << "  Forge kernel fwd+rev:     " << std::setw(10) << kernel_ms << " ms\n";
+    std::cout << "Total for " << reuses << " evaluations (incl. start-up):\n";
+    std::cout << "  Interpreter:              " << std::setw(10) << front_ms + build_ms + reuses * interp_ms
+              << " ms\n";
+    std::cout << "  Forge kernel:             " << std::setw(10) << front_ms + compile_ms + reuses * kernel_ms
+              << " ms\n";
+
+    const double err = std::max({maxError(interp_gradient, xad_gradient),
+                                 maxError(batch_gradient, xad_gradient),
+                                 maxError(kernel_gradient, xad_gradient), jit_err});
+    std::cout << "Max rel. error vs XAD: " << std::scientific << err << "\n";
+
+    const bool ok = err < 1e-12;
+    std::cout << (ok ? "✓ Interpreter matches XAD\n" : "✗ Gradient mismatch\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,185 @@
+/**
+ * @file graph_optimizer_benchmark.cpp
+ * @brief Kernel speedup contributed by each graph optimizer pass
+ *
+ * Records a tape with the redundancy typical of generic pricing code
+ * (recomputed discount factors, multiplications by unit notionals, zero
+ * spreads, r * r), then compiles it once per pass configuration and
+ * times the kernel. Gradients are checked against the unoptimized kernel.
+ *
+ * Usage: graph_optimizer_benchmark [iterations]   (default 20000)
+ */
+
+#include "forge_xad/activity_analysis.hpp"
+#include "forge_xad/graph_optimizer.hpp"
+#include "forge_xad/xad_tape_converter.hpp"
+#include <XAD/XAD.hpp>
+#include <compiler/forge_engine.hpp>
+#include <compiler/compiler_config.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using mode = xad::adj<double>;
+using tape_type = mode::tape_type;
+using AD = mode::active_type;
+
+constexpr std::size_t kNumRates = 8;
+constexpr std::size_t kNumPeriods = 40;
+
+void recordSwapLikeTape(tape_type& tape) {
+    std::vector<AD> rates(kNumRates);
+    for (std::size_t i = 0; i < kNumRates; ++i) {
+        value(rates[i]) = 0.01 + 0.002 * i;
+        tape.registerInput(rates[i]);
+    }
+    tape.newRecording();
+
+    const double notional = 1.0;
+    const double spread = 0.0;
+    const double accrual = 0.25;
+    const double year_fraction_scale = 2.0 / 2.0;  // folds to 1.0
+
+    AD pv = rates[0] * 0.0;
+    for (std::size_t k = 0; k < kNumPeriods; ++k) {
+        const AD& r = rates[k % kNumRates];
+        const double t = accrual * (k + 1);
+
+        // Discount factor recomputed for both legs, as generic leg code does
+        AD df_fixed = exp(-(r * t));
+        AD df_float = exp(-(r * t));
+
+        AD fixed = notional * (r + spread) * accrual * df_fixed;
+        AD floating = (r * year_fraction_scale) * accrual * df_float / 1.0;
+        AD convexity = (r * r) * t;
+
+        pv = pv + (floating - fixed) + convexity + (r - r);
+    }
+    tape.registerOutput(pv);
+    derivative(pv) = 1.0;
+}
+
+struct Measurement {
+    std::size_t liveNodes = 0;
+    double nsPerRun = 0.0;
+    std::vector<double> gradients;
+};
+
+Measurement measure(const forge_xad::ConversionResult& base,
+                    const forge_xad::GraphOptimizerOptions& options,
+                    const std::vector<double>& inputs,
+                    int iterations) {
+    forge_xad::ConversionResult conversion = base;
+    forge_xad::optimizeGraph(conversion, options);
+    forge_xad::analyzeActivity(conversion.graph);
+
+    Measurement m;
+    for (const auto& node : conversion.graph.nodes) {
+        if (!node.isDead) {
+            ++m.liveNodes;
+        }
+    }
+
+    forge::CompilerConfig config = forge::CompilerConfig::Default();
+    config.instructionSet = forge::CompilerConfig::InstructionSet::SSE2_SCALAR;
+    forge::ForgeEngine engine(config);
+    auto kernel = engine.compile(conversion.graph);
+    auto buffer = forge::NodeValueBufferFactory::create(conversion.graph, *kernel);
+
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        buffer->setValue(conversion.input_nodes[i], inputs[i]);
+    }
+
+    auto run = [&]() {
+        buffer->clearGradients();
+        buffer->getGradientsPtr()[conversion.output_nodes[0]] = 1.0;
+        kernel->executeDirect(buffer->getValuesPtr(), buffer->getGradientsPtr(), buffer->getNumNodes());
+    };
+
+    run();  // warm-up
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        run();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    m.nsPerRun = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+
+    for (auto node : conversion.input_nodes) {
+        m.gradients.push_back(buffer->getGradient(node));
+    }
+    return m;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 20000;
+
+    std::cout << "========================================\n";
+    std::cout << "Graph Optimizer Benchmark\n";
+    std::cout << "========================================\n\n";
+
+    tape_type tape;
+    recordSwapLikeTape(tape);
+    const forge_xad::ConversionResult base = forge_xad::convertXadTapeToForge(tape);
+
+    std::vector<double> inputs;
+    for (std::size_t i = 0; i < kNumRates; ++i) {
+        inputs.push_back(0.01 + 0.002 * i);
+    }
+
+    struct Config {
+        std::string name;
+        forge_xad::GraphOptimizerOptions options;
+    };
+    std::vector<Config> configs;
+    configs.push_back({"none", forge_xad::GraphOptimizerOptions::None()});
+    {
+        auto options = forge_xad::GraphOptimizerOptions::None();
+        options.constantFolding = true;
+        configs.push_back({"constant folding", options});
+    }
+    {
+        auto options = forge_xad::GraphOptimizerOptions::None();
+        options.commonSubexpressionElimination = true;
+        configs.push_back({"CSE", options});
+    }
+    {
+        auto options = forge_xad::GraphOptimizerOptions::None();
+        options.algebraicSimplification = true;
+        configs.push_back({"algebraic", options});
+    }
+    configs.push_back({"all passes", forge_xad::GraphOptimizerOptions()});
+
+    std::cout << std::setw(18) << "passes" << std::setw(12) << "live nodes"
+              << std::setw(12) << "ns/run" << std::setw(10) << "speedup" << "\n";
+
+    Measurement reference;
+    bool all_match = true;
+    for (std::size_t c = 0; c < configs.size(); ++c) {
+        Measurement m = measure(base, configs[c].options, inputs, iterations);
+        if (c == 0) {
+            reference = m;
+        }
+        for (std::size_t i = 0; i < m.gradients.size(); ++i) {
+            const double diff = std::abs(m.gradients[i] - reference.gradients[i]);
+            if (diff > 1e-12 * (1.0 + std::abs(reference.gradients[i]))) {
+                all_match = false;
+            }
+        }
+        std::cout << std::setw(18) << configs[c].name << std::setw(12) << m.liveNodes
+                  << std::setw(12) << std::fixed << std::setprecision(1) << m.nsPerRun
+                  << std::setw(9) << std::setprecision(2) << reference.nsPerRun / m.nsPerRun << "x\n";
+    }
+
+    std::cout << "\nGradients " << (all_match ? "match" : "DO NOT match")
+              << " the unoptimized kernel\n";
+    return all_match ? 0 : 1;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file hessian_benchmark.cpp
+ * @brief Compiled Hessians vs. XAD forward-over-adjoint mode
+ *
+ * Gamma / cross-gamma of a basket-style function of kNumInputs inputs
+ * over many scenarios:
+ *   1. XAD fwd_adj: one recording and reverse sweep per input direction,
+ *      re-recorded for every scenario
+ *   2. JITTape::computeHessian(): recorded once, then a compiled
+ *      second-order kernel with LANES directions per call
+ * plus single Hessian-vector products with both. Results are compared.
+ *
+ * Usage: hessian_benchmark [scenarios]   (default 200)
+ */
+
+#include "forge_xad/jit_tape.hpp"
+#include <XAD/XAD.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+using mode = xad::adj<double>;
+using tape_type = mode::tape_type;
+using AD = mode::active_type;
+
+using mode2 = xad::fwd_adj<double>;
+using tape2_type = mode2::tape_type;
+using AD2 = mode2::active_type;
+
+using Clock = std::chrono::high_resolution_clock;
+
+constexpr int kNumInputs = 8;
+
+// Smooth basket payoff with cross terms between all inputs
+template<typename T>
+T basket(const std::vector<T>& x) {
+    T sum = exp(x[0] * 0.1);
+    T norm = x[0] * x[0];
+    for (int i = 1; i < kNumInputs; ++i) {
+        sum = sum + exp(x[i] * 0.1) * (1.0 + 0.05 * i);
+        norm = norm + x[i] * x[i];
+    }
+    T coupling = x[0] * x[kNumInputs - 1];
+    for (int i = 1; i < kNumInputs; ++i) {
+        coupling = coupling + x[i - 1] * x[i];
+    }
+    return log(sum) * sqrt(norm) + coupling * 0.01;
+}
+
+double inputValue(int scenario, int i) {
+    return 1.0 + 0.1 * i + 0.001 * scenario;
+}
+
+// Column `direction` of the Hessian (H e_direction) by one fwd_adj sweep
+void xadHessianColumn(tape2_type& tape, int scenario, const double* direction, double* column) {
+    std::vector<AD2> x(kNumInputs);
+    for (int i = 0; i < kNumInputs; ++i) {
+        value(x[i]) = inputValue(scenario, i);
+        tape.registerInput(x[i]);
+        derivative(value(x[i])) = direction[i];
+    }
+    tape.newRecording();
+    AD2 y = basket(x);
+    tape.registerOutput(y);
+    value(derivative(y)) = 1.0;
+    tape.computeAdjoints();
+    for (int i = 0; i < kNumInputs; ++i) {
+        column[i] = derivative(derivative(x[i]));
+    }
+    tape.clearAll();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int scenarios = argc > 1 ? std::atoi(argv[1]) : 200;
+
+    std::cout << "========================================\n";
+    std::cout << "Hessian Benchmark (" << kNumInputs << " inputs)\n";
+    std::cout << "========================================\n\n";
+
+    // Record once for the JIT path; the variables stay bound
+    forge_xad::JITTape<tape_type> jit;
+    std::vector<AD> x(kNumInputs);
+    for (int i = 0; i < kNumInputs; ++i) {
+        x[i] = inputValue(0, i);
+        jit.registerInput(x[i]);
+    }
+    jit.newRecording();
+    AD y = basket(x);
+    jit.registerOutput(y);
+    jit.getHessianKernel();  // compile outside the timed loop
+
+    tape2_type tape2;
+    std::vector<double> unit(kNumInputs), direction(kNumInputs);
+    for (int i = 0; i < kNumInputs; ++i) {
+        direction[i] = 1.0 / (1.0 + i);
+    }
+
+    // ===== Full Hessians =====
+    std::vector<std::vector<double>> xad_hessians(scenarios, std::vector<double>(kNumInputs * kNumInputs));
+    auto t0 = Clock::now();
+    for (int s = 0; s < scenarios; ++s) {
+        for (int i = 0; i < kNumInputs; ++i) {
+            std::fill(unit.begin(), unit.end(), 0.0);
+            unit[i] = 1.0;
+            xadHessianColumn(tape2, s, unit.data(), &xad_hessians[s][i * kNumInputs]);
+        }
+    }
+    const double xad_ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+    double max_err = 0.0;
+    std::vector<std::vector<double>> jit_hessians(scenarios);
+    t0 = Clock::now();
+    for (int s = 0; s < scenarios; ++s) {
+        for (int i = 0; i < kNumInputs; ++i) {
+            value(x[i]) = inputValue(s, i);
+        }
+        jit_hessians[s] = jit.computeHessian();
+    }
+    const double jit_ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    for (int s = 0; s < scenarios; ++s) {
+        for (int k = 0; k < kNumInputs * kNumInputs; ++k) {
+            max_err = std::max(max_err, std::abs(jit_hessians[s][k] - xad_hessians[s][k]));
+        }
+    }
+
+    // ===== Hessian-vector products =====
+    std::vector<double> xad_hvp(kNumInputs), jit_hvp;
+    t0 = Clock::now();
+    for (int s = 0; s < scenarios; ++s) {
+        xadHessianColumn(tape2, s, direction.data(), xad_hvp.data());
+    }
+    const double xad_hvp_ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    t0 = Clock::now();
+    for (int s = 0; s < scenarios; ++s) {
+        for (int i = 0; i < kNumInputs; ++i) {
+            value(x[i]) = inputValue(s, i);
+        }
+        jit_hvp = jit.hessianVectorProduct(direction.data());
+    }
+    const double jit_hvp_ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    for (int i = 0; i < kNumInputs; ++i) {
+        max_err = std::max(max_err, std::abs(jit_hvp[i] - xad_hvp[i]));
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "\nFull Hessian, " << scenarios << " scenarios:\n";
+    std::cout << "  XAD fwd_adj:  " << std::setw(10) << xad_ms << " ms\n";
+    std::cout << "  JIT Hessian:  " << std::setw(10) << jit_ms << " ms  ("
+              << xad_ms / jit_ms << "x)\n";
+    std::cout << "Hessian-vector product, " << scenarios << " scenarios:\n";
+    std::cout << "  XAD fwd_adj:  " << std::setw(10) << xad_hvp_ms << " ms\n";
+    std::cout << "  JIT HVP:      " << std::setw(10) << jit_hvp_ms << " ms  ("
+              << xad_hvp_ms / jit_hvp_ms << "x)\n";
+    std::cout << "Max abs error vs XAD: " << std::scientific << max_err << "\n";
+
+    const bool ok = max_err < 1e-10;
+    std::cout << (ok ? "✓ Hessians match XAD fwd_adj\n" : "✗ Hessian mismatch\n");
+    return ok ? 0 : 1;
+}
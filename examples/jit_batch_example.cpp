@@ -0,0 +1,112 @@
+/**
+ * @file jit_batch_example.cpp
+ * @brief Batched (AVX2, 4-lane) evaluation of a compiled tape
+ *
+ * Records f(x, y, z) once, then prices many scenarios through
+ * JITTape::computeBatch() and checks every scenario against a freshly
+ * recorded XAD tape. The scenario count is deliberately not a multiple
+ * of the lane width to exercise the tail batch.
+ */
+
+#include "forge_xad/jit_tape.hpp"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+using mode = xad::adj<double>;
+using tape_type = mode::tape_type;
+using AD = mode::active_type;
+
+template<typename T>
+T payoff(const T& x, const T& y, const T& z) {
+    return x * y + exp(z) * 0.5 - sqrt(x * x + y * y);
+}
+
+void referenceAdjoints(double x0, double y0, double z0, double& f, double* grads) {
+    tape_type tape;
+    AD x = x0, y = y0, z = z0;
+    tape.registerInput(x);
+    tape.registerInput(y);
+    tape.registerInput(z);
+    tape.newRecording();
+    AD r = payoff(x, y, z);
+    tape.registerOutput(r);
+    derivative(r) = 1.0;
+    tape.computeAdjoints();
+    f = value(r);
+    grads[0] = derivative(x);
+    grads[1] = derivative(y);
+    grads[2] = derivative(z);
+}
+
+} // namespace
+
+int main() {
+    std::cout << "========================================\n";
+    std::cout << "JITTape Batch Example (AVX2)\n";
+    std::cout << "========================================\n\n";
+
+    const std::size_t numScenarios = 10003;
+    const std::size_t numInputs = 3;
+
+    // Record and compile once
+    forge_xad::JITTape<tape_type> tape;
+    {
+        AD x = 1.0, y = 2.0, z = 0.5;
+        tape.registerInput(x);
+        tape.registerInput(y);
+        tape.registerInput(z);
+        tape.newRecording();
+        AD r = payoff(x, y, z);
+        tape.registerOutput(r);
+        derivative(r) = 1.0;
+        tape.computeAdjoints();
+    }
+
+    // Structure-of-arrays scenario data
+    std::vector<double> inputs(numInputs * numScenarios);
+    for (std::size_t s = 0; s < numScenarios; ++s) {
+        inputs[0 * numScenarios + s] = 1.0 + 0.0001 * s;
+        inputs[1 * numScenarios + s] = 2.0 - 0.0001 * s;
+        inputs[2 * numScenarios + s] = 0.5 + 0.00005 * s;
+    }
+    std::vector<double> outputs(numScenarios);
+    std::vector<double> grads(numInputs * numScenarios);
+
+    // Compile the AVX2 kernel outside the timed region
+    tape.getBatchKernel();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    tape.computeBatch(numScenarios, inputs.data(), outputs.data(), grads.data());
+    auto end = std::chrono::high_resolution_clock::now();
+    double batch_us = std::chrono::duration<double, std::micro>(end - start).count();
+
+    // Verify against XAD for every scenario (one active tape at a time)
+    tape.deactivate();
+    double max_err = 0.0;
+    for (std::size_t s = 0; s < numScenarios; ++s) {
+        double f;
+        double g[3];
+        referenceAdjoints(inputs[s], inputs[numScenarios + s], inputs[2 * numScenarios + s], f, g);
+        max_err = std::max(max_err, std::abs(f - outputs[s]));
+        for (std::size_t i = 0; i < numInputs; ++i) {
+            max_err = std::max(max_err, std::abs(g[i] - grads[i * numScenarios + s]));
+        }
+    }
+
+    std::cout << "Scenarios: " << numScenarios << " (tail of "
+              << numScenarios % forge_xad::BatchKernel::LANES << ")\n";
+    std::cout << "Batch time: " << batch_us << " us ("
+              << batch_us * 1000.0 / numScenarios << " ns/scenario)\n";
+    std::cout << "Max abs error vs XAD: " << max_err << "\n";
+
+    if (max_err < 1e-10) {
+        std::cout << "✓ Batch results match XAD\n";
+        return 0;
+    }
+    std::cout << "✗ Batch results differ from XAD\n";
+    return 1;
+}
@@ -0,0 +1,156 @@
+/**
+ * @file jit_replay_benchmark.cpp
+ * @brief Per-iteration cost of recording vs. record-free replay
+ *
+ * Runs the same pricing-style function three ways and splits each
+ * iteration into the recording phase (registerInput .. registerOutput)
+ * and the adjoint phase (computeAdjoints):
+ *   1. Plain XAD tape
+ *   2. JITTape (records every iteration, adjoints from the kernel)
+ *   3. JITTape in replay mode (no tape writes after compilation)
+ * A second pass registers two outputs per iteration, with different seeds.
+ */
+
+#include "forge_xad/jit_tape.hpp"
+#include <XAD/XAD.hpp>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+namespace {
+
+using mode = xad::adj<double>;
+using tape_type = mode::tape_type;
+using AD = mode::active_type;
+using Clock = std::chrono::high_resolution_clock;
+
+constexpr int kNumInputs = 32;
+constexpr int kNumIterations = 2000;
+
+// Sum of discounted payoffs over a small "curve"
+template<typename T>
+T priceFunction(const std::vector<T>& x) {
+    T sum = x[0] * 0.0;
+    for (size_t i = 1; i < x.size(); ++i) {
+        T df = exp(-x[i] * 0.01);
+        sum = sum + df * x[i - 1] * x[i] + sin(x[i]) * 0.5;
+    }
+    return sum;
+}
+
+struct Timing {
+    double record_ms = 0.0;
+    double adjoint_ms = 0.0;
+    double checksum = 0.0;
+};
+
+double elapsedMs(Clock::time_point start, Clock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Second output of the multi-output runs
+template<typename T>
+T forwardSum(const std::vector<T>& x) {
+    T sum = x[0] * x[0];
+    for (size_t i = 1; i < x.size(); ++i) {
+        sum = sum + log(x[i]) * x[i - 1];
+    }
+    return sum;
+}
+
+template<class Tape>
+Timing runLoop(Tape& tape, bool twoOutputs) {
+    Timing t;
+    for (int iter = 0; iter < kNumIterations; ++iter) {
+        std::vector<AD> x(kNumInputs);
+        for (int i = 0; i < kNumInputs; ++i) {
+            value(x[i]) = 1.0 + 0.01 * i + 0.001 * iter;
+        }
+
+        auto rec_start = Clock::now();
+        for (auto& xi : x) {
+            tape.registerInput(xi);
+        }
+        tape.newRecording();
+        AD y = priceFunction(x);
+        tape.registerOutput(y);
+        AD z = twoOutputs ? forwardSum(x) : y;
+        if (twoOutputs) {
+            tape.registerOutput(z);
+        }
+        auto rec_end = Clock::now();
+
+        derivative(y) = 1.0;
+        if (twoOutputs) {
+            derivative(z) = 0.5;
+        }
+        tape.computeAdjoints();
+        auto adj_end = Clock::now();
+
+        t.record_ms += elapsedMs(rec_start, rec_end);
+        t.adjoint_ms += elapsedMs(rec_end, adj_end);
+        t.checksum += value(y) + derivative(x[0]) + derivative(x[kNumInputs - 1]);
+        if (twoOutputs) {
+            t.checksum += value(z) + derivative(x[kNumInputs / 2]);
+        }
+
+        tape.clearAll();
+    }
+    return t;
+}
+
+void report(const char* name, const Timing& t) {
+    std::cout << std::left << std::setw(22) << name << std::right
+              << std::setw(12) << t.record_ms * 1000.0 / kNumIterations
+              << std::setw(12) << t.adjoint_ms * 1000.0 / kNumIterations
+              << std::setw(16) << t.checksum << "\n";
+}
+
+bool agree(const Timing& a, const Timing& b) {
+    return std::abs(a.checksum - b.checksum) < 1e-6 * std::abs(a.checksum);
+}
+
+// Runs the three modes and prints their timings; true if all agree
+bool runModes(bool twoOutputs) {
+    Timing baseline, recording, replay;
+    {
+        tape_type tape;
+        baseline = runLoop(tape, twoOutputs);
+    }
+    {
+        forge_xad::JITTape<tape_type> tape;
+        recording = runLoop(tape, twoOutputs);
+    }
+    {
+        forge_xad::JITTape<tape_type> tape;
+        tape.setReplayMode(true);
+        replay = runLoop(tape, twoOutputs);
+    }
+
+    std::cout << "\n" << (twoOutputs ? "Two outputs" : "One output") << "\n";
+    std::cout << std::left << std::setw(22) << "Mode" << std::right
+              << std::setw(12) << "record/us" << std::setw(12) << "adjoint/us"
+              << std::setw(16) << "checksum" << "\n";
+    report("XAD tape", baseline);
+    report("JITTape (recording)", recording);
+    report("JITTape (replay)", replay);
+    return agree(baseline, recording) && agree(baseline, replay);
+}
+
+} // namespace
+
+int main() {
+    std::cout << "========================================\n";
+    std::cout << "JITTape Replay Benchmark\n";
+    std::cout << "========================================\n";
+    std::cout << kNumInputs << " inputs, " << kNumIterations << " iterations\n";
+
+    // All three modes must agree on values and gradients
+    const bool single_ok = runModes(false);
+    const bool multi_ok = runModes(true);
+    const bool ok = single_ok && multi_ok;
+    std::cout << "\n" << (ok ? "✓ Results match\n" : "✗ Results differ!\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file kernel_cache_example.cpp
+ * @brief Persistent kernel cache across "process restarts"
+ *
+ * Simulates restarts by creating fresh JITTape instances that share a
+ * cache directory: the first one converts and stores, later ones load the
+ * converted graph. Then the entry is corrupted on disk to show that it
+ * is detected, rejected and rebuilt. Finally its second fingerprint hash
+ * is altered, as if another recording had the same key, which must be a
+ * miss rather than a hit.
+ *
+ * Usage: kernel_cache_example [cache_dir]
+ */
+
+#include "forge_xad/jit_tape.hpp"
+#include "forge_xad/kernel_cache.hpp"
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+using mode = xad::adj<double>;
+using tape_type = mode::tape_type;
+using AD = mode::active_type;
+
+constexpr int kNumInputs = 200;
+
+// One "restart": record, compile (through the cache) and price once
+double priceOnce(const std::shared_ptr<forge_xad::KernelCache>& cache, double& grad0) {
+    forge_xad::JITTape<tape_type> tape;
+    tape.setKernelCache(cache);
+
+    std::vector<AD> x(kNumInputs);
+    for (int i = 0; i < kNumInputs; ++i) {
+        value(x[i]) = 1.0 + 0.001 * i;
+        tape.registerInput(x[i]);
+    }
+    tape.newRecording();
+    AD y = x[0] * 0.0;
+    for (int i = 1; i < kNumInputs; ++i) {
+        y = y + log(x[i]) * x[i - 1] * 0.25;
+    }
+    tape.registerOutput(y);
+    derivative(y) = 1.0;
+    tape.computeAdjoints();
+
+    grad0 = derivative(x[0]);
+    return value(y);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::string dir = argc > 1 ? argv[1] : "forge_xad_kernel_cache";
+    std::filesystem::remove_all(dir);
+    auto cache = std::make_shared<forge_xad::KernelCache>(dir);
+
+    std::cout << "========================================\n";
+    std::cout << "Kernel Cache Example (" << dir << ")\n";
+    std::cout << "========================================\n\n";
+
+    double g_cold, g_warm, g_repaired, g_collided;
+    double v_cold = priceOnce(cache, g_cold);
+    double v_warm = priceOnce(cache, g_warm);
+
+    // Corrupt every entry on disk
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        std::fstream f(entry.path(), std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(-1, std::ios::end);
+        f.put('\x5a');
+    }
+    double v_repaired = priceOnce(cache, g_repaired);
+
+    // Same key, different second hash (it follows magic, version and key)
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        std::fstream f(entry.path(), std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(16);
+        f.put('\x5a');
+    }
+    double v_collided = priceOnce(cache, g_collided);
+
+    const auto& stats = cache->stats();
+    std::cout << "\nHits: " << stats.hits << ", misses: " << stats.misses
+              << ", rejected: " << stats.rejected << ", stores: " << stats.stores << "\n";
+
+    bool ok = stats.hits == 1 && stats.rejected == 1 && stats.stores == 3 && stats.misses == 3 &&
+              v_cold == v_warm && v_cold == v_repaired && v_cold == v_collided &&
+              g_cold == g_warm && g_cold == g_repaired && g_cold == g_collided;
+    std::cout << (ok ? "✓ Cache hit, corruption and key collision detected, entry rebuilt\n"
+                     : "✗ Unexpected cache behaviour\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file primal_kernel_benchmark.cpp
+ * @brief Price-only re-evaluation: primal kernel vs. full adjoint kernel
+ *
+ * Records a pricing function once, then repeatedly bumps the inputs and
+ * recomputes the price two ways:
+ *   1. computeAdjoints() - forward + reverse kernel (values come along)
+ *   2. evaluate()        - forward-only kernel, no gradient buffers
+ * Prices are checked against a plain double evaluation.
+ *
+ * Usage: primal_kernel_benchmark [iterations]   (default 20000)
+ */
+
+#include "forge_xad/jit_tape.hpp"
+#include <XAD/XAD.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+using mode = xad::adj<double>;
+using tape_type = mode::tape_type;
+using AD = mode::active_type;
+using Clock = std::chrono::high_resolution_clock;
+
+constexpr int kNumInputs = 64;
+
+template<typename T>
+T priceFunction(const std::vector<T>& x) {
+    T sum = x[0] * 0.0;
+    for (size_t i = 1; i < x.size(); ++i) {
+        T df = exp(-x[i] * 0.01);
+        sum = sum + df * x[i - 1] * x[i] + sin(x[i]) * 0.5 + sqrt(x[i] * x[i] + 1.0);
+    }
+    return sum;
+}
+
+double inputValue(int i, int iter) { return 1.0 + 0.01 * i + 1e-4 * (iter % 100); }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 20000;
+
+    std::cout << "========================================\n";
+    std::cout << "Primal Kernel Benchmark\n";
+    std::cout << "========================================\n";
+    std::cout << kNumInputs << " inputs, " << iterations << " re-evaluations\n\n";
+
+    forge_xad::JITTape<tape_type> tape;
+    std::vector<AD> x(kNumInputs);
+    for (int i = 0; i < kNumInputs; ++i) {
+        value(x[i]) = inputValue(i, 0);
+        tape.registerInput(x[i]);
+    }
+    tape.newRecording();
+    AD y = priceFunction(x);
+    tape.registerOutput(y);
+    derivative(y) = 1.0;
+    tape.computeAdjoints();  // compiles the adjoint kernel
+    tape.evaluate();         // compiles the primal kernel
+
+    double max_error = 0.0;
+    auto checkPrice = [&](int iter) {
+        std::vector<double> xd(kNumInputs);
+        for (int i = 0; i < kNumInputs; ++i) {
+            xd[i] = inputValue(i, iter);
+        }
+        max_error = std::max(max_error, std::abs(value(y) - priceFunction(xd)));
+    };
+
+    auto bumpInputs = [&](int iter) {
+        for (int i = 0; i < kNumInputs; ++i) {
+            value(x[i]) = inputValue(i, iter);
+        }
+    };
+
+    auto start = Clock::now();
+    for (int iter = 0; iter < iterations; ++iter) {
+        bumpInputs(iter);
+        tape.computeAdjoints();
+    }
+    auto mid = Clock::now();
+    checkPrice(iterations - 1);
+
+    for (int iter = 0; iter < iterations; ++iter) {
+        bumpInputs(iter);
+        tape.evaluate();
+    }
+    auto end = Clock::now();
+    checkPrice(iterations - 1);
+
+    const double adjoint_ns = std::chrono::duration<double, std::nano>(mid - start).count() / iterations;
+    const double primal_ns = std::chrono::duration<double, std::nano>(end - mid).count() / iterations;
+
+    std::cout << "\n" << std::left << std::setw(26) << "Kernel" << std::right
+              << std::setw(12) << "ns/call" << "\n";
+    std::cout << std::left << std::setw(26) << "forward + reverse" << std::right
+              << std::setw(12) << std::fixed << std::setprecision(1) << adjoint_ns << "\n";
+    std::cout << std::left << std::setw(26) << "forward only (evaluate)" << std::right
+              << std::setw(12) << primal_ns << "\n";
+    std::cout << "Speedup: " << std::setprecision(2) << adjoint_ns / primal_ns << "x\n";
+
+    std::cout << "\nMax abs price error: " << std::scientific << max_error << "\n";
+    const bool ok = max_error < 1e-10;
+    std::cout << (ok ? "✓ Prices match plain double evaluation\n" : "✗ Prices differ!\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file sparse_jacobian_benchmark.cpp
+ * @brief Sparse Jacobian via output colouring vs. dense Jacobian
+ *
+ * A portfolio of trades where each trade PV depends only on the three
+ * curve pillars of its own maturity bucket. Trades in different buckets
+ * share no inputs, so they can be seeded together: the number of reverse
+ * sweeps falls from #trades to #colours. The sparse result is checked
+ * against the dense computeJacobian().
+ *
+ * Usage: sparse_jacobian_benchmark [repetitions]   (default 200)
+ */
+
+#include "forge_xad/jit_tape.hpp"
+#include <XAD/XAD.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+using mode = xad::adj<double>;
+using tape_type = mode::tape_type;
+using AD = mode::active_type;
+using Clock = std::chrono::high_resolution_clock;
+
+constexpr int kNumBuckets = 20;
+constexpr int kPillarsPerBucket = 3;
+constexpr int kNumPillars = kNumBuckets * kPillarsPerBucket;
+constexpr int kNumTrades = 200;
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int repetitions = argc > 1 ? std::atoi(argv[1]) : 200;
+
+    std::cout << "========================================\n";
+    std::cout << "Sparse Jacobian Benchmark\n";
+    std::cout << "========================================\n";
+    std::cout << kNumTrades << " trades x " << kNumPillars << " pillars\n\n";
+
+    forge_xad::JITTape<tape_type> tape;
+    std::vector<AD> pillars(kNumPillars);
+    for (int i = 0; i < kNumPillars; ++i) {
+        value(pillars[i]) = 0.01 + 0.0005 * i;
+        tape.registerInput(pillars[i]);
+    }
+    tape.newRecording();
+
+    std::vector<AD> pvs(kNumTrades);
+    for (int t = 0; t < kNumTrades; ++t) {
+        const int first = (t % kNumBuckets) * kPillarsPerBucket;
+        const double maturity = 1.0 + 0.05 * t;
+        AD rate = pillars[first] * 0.25 + pillars[first + 1] * 0.5 + pillars[first + 2] * 0.25;
+        pvs[t] = exp(-(rate * maturity)) * (1.0 + 0.01 * t);
+        tape.registerOutput(pvs[t]);
+    }
+
+    std::vector<double> dense = tape.computeJacobian();            // compiles
+    forge_xad::SparseJacobian sparse = tape.computeSparseJacobian();  // colours
+
+    auto start = Clock::now();
+    for (int rep = 0; rep < repetitions; ++rep) {
+        dense = tape.computeJacobian();
+    }
+    auto mid = Clock::now();
+    for (int rep = 0; rep < repetitions; ++rep) {
+        sparse = tape.computeSparseJacobian();
+    }
+    auto end = Clock::now();
+
+    const double dense_us = std::chrono::duration<double, std::micro>(mid - start).count() / repetitions;
+    const double sparse_us = std::chrono::duration<double, std::micro>(end - mid).count() / repetitions;
+    const auto* colouring = tape.getJacobianColouring();
+
+    std::cout << "\nNonzeros: " << sparse.values.size() << " of " << dense.size() << "\n";
+    std::cout << "Reverse sweeps: " << colouring->numColours << " (dense: " << kNumTrades << ")\n\n";
+    std::cout << std::left << std::setw(24) << "Method" << std::right
+              << std::setw(14) << "us/Jacobian" << "\n";
+    std::cout << std::left << std::setw(24) << "dense" << std::right
+              << std::setw(14) << std::fixed << std::setprecision(2) << dense_us << "\n";
+    std::cout << std::left << std::setw(24) << "coloured (CSR)" << std::right
+              << std::setw(14) << sparse_us << "\n";
+    std::cout << "Speedup: " << dense_us / sparse_us << "x\n";
+
+    // Every dense entry must be either in the pattern with the same value,
+    // or outside it and zero
+    double max_diff = 0.0;
+    std::vector<double> expanded(dense.size(), 0.0);
+    for (std::size_t j = 0; j < sparse.numRows; ++j) {
+        for (std::size_t k = sparse.rowOffsets[j]; k < sparse.rowOffsets[j + 1]; ++k) {
+            expanded[j * sparse.numCols + sparse.columns[k]] = sparse.values[k];
+        }
+    }
+    for (std::size_t k = 0; k < dense.size(); ++k) {
+        max_diff = std::max(max_diff, std::abs(expanded[k] - dense[k]));
+    }
+    std::cout << "\nMax abs difference vs dense: " << std::scientific << max_diff << "\n";
+    const bool ok = max_diff < 1e-12 && colouring->numColours == kNumTrades / kNumBuckets;
+    std::cout << (ok ? "✓ Sparse Jacobian matches dense\n" : "✗ Sparse Jacobian differs!\n");
+    return ok ? 0 : 1;
+}
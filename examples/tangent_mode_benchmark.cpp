@@ -0,0 +1,141 @@
+/**
+ * @file tangent_mode_benchmark.cpp
+ * @brief Compiled tangent mode vs. XAD's FReal forward mode
+ *
+ * A scenario grid: 3 model inputs (spot, vol, rate) and one price per
+ * grid point, so forward mode needs 3 directions while reverse mode would
+ * need one sweep per output. Compares
+ *   1. xad::fwd (FReal): one pass of the C++ function per direction
+ *   2. JITTape::computeTangents(): all directions through the compiled
+ *      tangent kernel, TangentKernel::LANES per call
+ *
+ * Usage: tangent_mode_benchmark [repetitions]   (default 500)
+ */
+
+#include "forge_xad/jit_tape.hpp"
+#include <XAD/XAD.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+constexpr int kNumInputs = 3;
+constexpr int kGridSize = 256;
+
+// Smooth lognormal-style prices over a strike/maturity grid
+template<typename T>
+std::vector<T> gridPrices(const std::vector<T>& x) {
+    const T& spot = x[0];
+    const T& vol = x[1];
+    const T& rate = x[2];
+    std::vector<T> prices;
+    prices.reserve(kGridSize);
+    for (int g = 0; g < kGridSize; ++g) {
+        const double t = 0.25 + 0.25 * (g % 16);
+        const double strike = 80.0 + 2.5 * (g / 16);
+        T forward = spot * exp(rate * t);
+        T variance = vol * vol * t;
+        T moneyness = log(forward / strike);
+        prices.push_back(exp(-(rate * t)) * (forward * exp(variance * 0.5) + sqrt(variance + moneyness * moneyness) - strike * 0.5));
+    }
+    return prices;
+}
+
+const std::vector<double> kInputs = {100.0, 0.2, 0.03};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int repetitions = argc > 1 ? std::atoi(argv[1]) : 500;
+
+    std::cout << "========================================\n";
+    std::cout << "Tangent Mode Benchmark\n";
+    std::cout << "========================================\n";
+    std::cout << kNumInputs << " inputs, " << kGridSize << " outputs\n\n";
+
+    // 1. XAD forward mode, one direction per pass
+    using fmode = xad::fwd<double>;
+    using FAD = fmode::active_type;
+    std::vector<double> fwd_tangents(kNumInputs * kGridSize);
+    auto fwd_start = Clock::now();
+    for (int rep = 0; rep < repetitions; ++rep) {
+        for (int d = 0; d < kNumInputs; ++d) {
+            std::vector<FAD> x(kNumInputs);
+            for (int i = 0; i < kNumInputs; ++i) {
+                value(x[i]) = kInputs[i];
+                derivative(x[i]) = (i == d) ? 1.0 : 0.0;
+            }
+            std::vector<FAD> y = gridPrices(x);
+            for (int j = 0; j < kGridSize; ++j) {
+                fwd_tangents[d * kGridSize + j] = derivative(y[j]);
+            }
+        }
+    }
+    auto fwd_end = Clock::now();
+
+    // 2. Compiled tangent kernel
+    using amode = xad::adj<double>;
+    using AD = amode::active_type;
+    forge_xad::JITTape<amode::tape_type> tape;
+    std::vector<AD> x(kNumInputs);
+    for (int i = 0; i < kNumInputs; ++i) {
+        value(x[i]) = kInputs[i];
+        tape.registerInput(x[i]);
+    }
+    tape.newRecording();
+    std::vector<AD> y = gridPrices(x);
+    for (auto& yj : y) {
+        tape.registerOutput(yj);
+    }
+
+    // Identity directions: one per input
+    std::vector<double> directions(kNumInputs * kNumInputs, 0.0);
+    for (int d = 0; d < kNumInputs; ++d) {
+        directions[d * kNumInputs + d] = 1.0;
+    }
+    std::vector<double> jit_tangents(kNumInputs * kGridSize);
+    tape.computeTangents(directions.data(), kNumInputs, jit_tangents.data());  // compiles
+
+    auto jit_start = Clock::now();
+    for (int rep = 0; rep < repetitions; ++rep) {
+        tape.computeTangents(directions.data(), kNumInputs, jit_tangents.data());
+    }
+    auto jit_end = Clock::now();
+
+    // Single-direction API mirrors FReal: seed derivative(x), read derivative(y)
+    for (int i = 0; i < kNumInputs; ++i) {
+        derivative(x[i]) = (i == 1) ? 1.0 : 0.0;
+    }
+    tape.computeTangents();
+    double max_diff = 0.0;
+    for (int j = 0; j < kGridSize; ++j) {
+        max_diff = std::max(max_diff, std::abs(derivative(y[j]) - fwd_tangents[1 * kGridSize + j]));
+    }
+
+    const double fwd_us = std::chrono::duration<double, std::micro>(fwd_end - fwd_start).count() / repetitions;
+    const double jit_us = std::chrono::duration<double, std::micro>(jit_end - jit_start).count() / repetitions;
+
+    std::cout << "\n" << std::left << std::setw(30) << "Method" << std::right
+              << std::setw(14) << "us/all dirs" << "\n";
+    std::cout << std::left << std::setw(30) << "XAD fwd (FReal)" << std::right
+              << std::setw(14) << std::fixed << std::setprecision(2) << fwd_us << "\n";
+    std::cout << std::left << std::setw(30) << "JITTape::computeTangents" << std::right
+              << std::setw(14) << jit_us << "\n";
+    std::cout << "Speedup: " << fwd_us / jit_us << "x\n";
+
+    for (std::size_t k = 0; k < jit_tangents.size(); ++k) {
+        const double scale = 1.0 + std::abs(fwd_tangents[k]);
+        max_diff = std::max(max_diff, std::abs(jit_tangents[k] - fwd_tangents[k]) / scale);
+    }
+    std::cout << "\nMax rel difference vs FReal: " << std::scientific << max_diff << "\n";
+    const bool ok = max_diff < 1e-12;
+    std::cout << (ok ? "✓ Tangents match XAD forward mode\n" : "✗ Tangents differ!\n");
+    return ok ? 0 : 1;
+}
@@ -5,11 +5,16 @@
  * Tests the basic converter functionality with simple operations.
  */
 
+#include "forge_xad/hessian_kernel.hpp"
+#include "forge_xad/jit_tape.hpp"
+#include "forge_xad/tangent_kernel.hpp"
 #include "forge_xad/xad_tape_converter.hpp"
 #include "forge_xad/operation_inference.hpp"
 #include <XAD/XAD.hpp>
+#include <cmath>
 #include <iostream>
 #include <iomanip>
+#include <vector>
 
 void printGraph(const forge::Graph& graph) {
     std::cout << "\nForge Graph Structure:\n";
@@ -255,6 +260,477 @@ bool testScalarMultiplication() {
     return ok;
 }
 
+bool testConstantInterning() {
+    std::cout << "\n=== Test 5: Constant Interning (z = 0.5*x + 0.5*y + 0.5) ===\n";
+
+    using mode = xad::adj<double>;
+    using tape_type = mode::tape_type;
+    using AD = mode::active_type;
+
+    tape_type tape;
+
+    AD x = 0.0, y = 0.0;
+    value(x) = 2.0;
+    value(y) = 6.0;
+
+    tape.registerInput(x);
+    tape.registerInput(y);
+    tape.newRecording();
+
+    AD z = 0.5 * x;
+    z = z + 0.5 * y;
+    z = z + 0.5;
+
+    tape.registerOutput(z);
+
+    auto result = forge_xad::convertXadTapeToForge(tape);
+    printGraph(result.graph);
+
+    std::cout << "\nVerification:\n";
+    bool ok = true;
+
+    // Three uses of 0.5 share a single Constant node and pool entry
+    size_t num_constants = 0;
+    for (const auto& node : result.graph.nodes) {
+        if (node.op == forge::OpCode::Constant) {
+            ++num_constants;
+        }
+    }
+    if (result.graph.constPool.size() != 1 || num_constants != 1) {
+        std::cout << "✗ Expected 1 constant, got " << num_constants << " nodes / "
+                  << result.graph.constPool.size() << " pool entries\n";
+        ok = false;
+    } else {
+        std::cout << "✓ Repeated literal interned into 1 constant\n";
+    }
+
+    return ok;
+}
+
+bool testActivityPruning() {
+    std::cout << "\n=== Test 6: Activity Pruning (z = x*y, diagnostic d = exp(x)) ===\n";
+
+    using mode = xad::adj<double>;
+    using tape_type = mode::tape_type;
+    using AD = mode::active_type;
+
+    tape_type tape;
+
+    AD x = 0.0, y = 0.0;
+    value(x) = 2.0;
+    value(y) = 3.0;
+
+    tape.registerInput(x);
+    tape.registerInput(y);
+    tape.newRecording();
+
+    AD diagnostic = exp(x);  // computed but never registered as output
+    AD z = x * y;
+
+    tape.registerOutput(z);
+
+    auto result = forge_xad::convertXadTapeToForge(tape);
+    printGraph(result.graph);
+
+    std::cout << "\nVerification:\n";
+    bool ok = true;
+
+    size_t live_ops = 0;
+    for (const auto& node : result.graph.nodes) {
+        if (node.isDead) {
+            if (node.needsGradient) {
+                std::cout << "✗ Dead node still needs a gradient\n";
+                ok = false;
+            }
+        } else if (node.op == forge::OpCode::Exp) {
+            std::cout << "✗ Unreachable Exp node is still live\n";
+            ok = false;
+        } else if (node.op != forge::OpCode::Input) {
+            ++live_ops;
+        }
+    }
+    if (ok && live_ops == 1) {
+        std::cout << "✓ Diagnostic branch pruned, only the Mul remains\n";
+    } else if (live_ops != 1) {
+        std::cout << "✗ Expected 1 live operation, got " << live_ops << "\n";
+        ok = false;
+    }
+    (void)diagnostic;
+
+    return ok;
+}
+
+bool testTangentGraph() {
+    std::cout << "\n=== Test 7: Tangent Graph (directional derivative vs. reverse mode) ===\n";
+
+    using mode = xad::adj<double>;
+    using tape_type = mode::tape_type;
+    using AD = mode::active_type;
+
+    tape_type tape;
+
+    AD x = 0.0, y = 0.0;
+    value(x) = 1.7;
+    value(y) = 0.6;
+
+    tape.registerInput(x);
+    tape.registerInput(y);
+    tape.newRecording();
+
+    // One of each opcode family with a tangent rule
+    AD z = max(x, y) * abs(y - x) + pow(x, y) / y + sqrt(x) * cos(y) - exp(-x) * tan(y);
+    z = z + log(x) * sin(y) + 1.0 / (x * x);
+
+    tape.registerOutput(z);
+    derivative(z) = 1.0;
+    tape.computeAdjoints();
+    const double dx = 0.3, dy = -1.1;
+    const double expected = derivative(x) * dx + derivative(y) * dy;
+
+    auto result = forge_xad::convertXadTapeToForge(tape);
+    forge_xad::TangentKernel kernel(result);
+    auto buffer = kernel.createBuffer();
+
+    const double inputs[] = {1.7, 0.6};
+    const double direction[] = {dx, dy};
+    double output = 0.0, tangent = 0.0;
+    kernel.execute(*buffer, inputs, direction, 1, &output, &tangent);
+
+    std::cout << "\nVerification:\n";
+    const bool ok = std::abs(tangent - expected) < 1e-12 * (1.0 + std::abs(expected)) &&
+                    std::abs(output - value(z)) < 1e-12;
+    if (ok) {
+        std::cout << "✓ Tangent " << tangent << " matches reverse-mode dot product\n";
+    } else {
+        std::cout << "✗ Tangent " << tangent << " (value " << output << "), expected "
+                  << expected << " (value " << value(z) << ")\n";
+    }
+    return ok;
+}
+
+bool testHessianKernel() {
+    std::cout << "\n=== Test 8: Hessian Kernel (analytic second derivatives) ===\n";
+
+    using mode = xad::adj<double>;
+    using tape_type = mode::tape_type;
+    using AD = mode::active_type;
+
+    tape_type tape;
+
+    const double x0 = 0.8, y0 = 1.3;
+    AD x = x0, y = y0;
+    tape.registerInput(x);
+    tape.registerInput(y);
+    tape.newRecording();
+
+    // f = x^2 y + exp(x y)
+    AD f = x * x * y + exp(x * y);
+    tape.registerOutput(f);
+
+    auto result = forge_xad::convertXadTapeToForge(tape);
+    forge_xad::HessianKernel kernel(result);
+    auto buffer = kernel.createBuffer();
+
+    const double inputs[] = {x0, y0};
+    double hessian[4], gradient[2], output = 0.0;
+    kernel.computeHessian(*buffer, inputs, nullptr, hessian, gradient, &output);
+
+    const double e = std::exp(x0 * y0);
+    const double expected_gradient[] = {2 * x0 * y0 + y0 * e, x0 * x0 + x0 * e};
+    const double expected_hessian[] = {2 * y0 + y0 * y0 * e, 2 * x0 + e + x0 * y0 * e,
+                                       2 * x0 + e + x0 * y0 * e, x0 * x0 * e};
+
+    std::cout << "\nVerification:\n";
+    bool ok = std::abs(output - value(f)) < 1e-12;
+    for (int k = 0; k < 4; ++k) {
+        ok = ok && std::abs(hessian[k] - expected_hessian[k]) < 1e-12;
+    }
+    for (int k = 0; k < 2; ++k) {
+        ok = ok && std::abs(gradient[k] - expected_gradient[k]) < 1e-12;
+    }
+    if (ok) {
+        std::cout << "✓ Hessian and gradient match analytic derivatives\n";
+    } else {
+        std::cout << "✗ Hessian [" << hessian[0] << ", " << hessian[1] << "; " << hessian[2] << ", "
+                  << hessian[3] << "], expected [" << expected_hessian[0] << ", "
+                  << expected_hessian[1] << "; " << expected_hessian[2] << ", "
+                  << expected_hessian[3] << "]\n";
+    }
+    return ok;
+}
+
+bool testMathFunctions() {
+    std::cout << "\n=== Test 9: Math Functions (lowered vs. host-evaluated) ===\n";
+
+    using mode = xad::adj<double>;
+    using tape_type = mode::tape_type;
+    using AD = mode::active_type;
+
+    std::cout << "\nVerification:\n";
+    bool ok = true;
+    {
+        tape_type tape;
+        AD x = 0.4, y = 1.6;
+        tape.registerInput(x);
+        tape.registerInput(y);
+        tape.newRecording();
+
+        // Lowered to primitives: no host nodes needed
+        AD z = log10(y) + log2(y) + exp2(x) + cbrt(x);
+        tape.registerOutput(z);
+        auto result = forge_xad::convertXadTapeToForge(tape);
+
+        const bool lowered = result.host_nodes.empty();
+        std::cout << (lowered ? "✓" : "✗") << " log10/log2, exp2 and cbrt lowered to "
+                  << result.graph.nodes.size() << " nodes\n";
+        ok = ok && lowered;
+        tape.deactivate();
+    }
+    {
+        tape_type tape;
+        AD x = 0.4, y = 1.6;
+        tape.registerInput(x);
+        tape.registerInput(y);
+        tape.newRecording();
+
+        // erf, atan2 and the hyperbolics need host functions
+        AD e = erf(x);
+        AD a = atan2(x, y);
+        AD z = e * a + sinh(x) * cosh(x) * tanh(x) * acosh(y) * atanh(x);
+        tape.registerOutput(z);
+        bool threw = false;
+        try {
+            forge_xad::convertXadTapeToForge(tape);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        forge_xad::ConversionOptions options;
+        options.hostFunctions = forge_xad::builtinHostFunctions().get();
+        auto result = forge_xad::convertXadTapeToForge(tape, options);
+
+        const bool hosted = threw && result.host_nodes.size() == 7 &&
+                            result.host_nodes[1].operands.size() == 2;
+        std::cout << (hosted ? "✓" : "✗")
+                  << " erf, atan2 and the hyperbolics become host nodes with the built-ins\n";
+        ok = ok && hosted;
+    }
+    return ok;
+}
+
+using MathAD = xad::adj<double>::active_type;
+
+struct MathCheck {
+    const char* name;
+    std::vector<double> x;
+    std::vector<double> y;  // second argument; empty for unary functions
+    MathAD (*apply)(const MathAD& x, const MathAD& y);
+};
+
+// Values followed by the adjoints of all inputs, every output seeded with 1.
+// prepare() runs between recording and seeding.
+template<class Tape, class Prepare>
+std::vector<double> evaluateMath(Tape& tape, const MathCheck& c, Prepare prepare) {
+    std::vector<MathAD> x(c.x.begin(), c.x.end()), y(c.y.begin(), c.y.end()), out(x.size());
+    for (auto& xi : x) {
+        tape.registerInput(xi);
+    }
+    for (auto& yi : y) {
+        tape.registerInput(yi);
+    }
+    tape.newRecording();
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        out[i] = c.apply(x[i], y.empty() ? x[i] : y[i]);
+        tape.registerOutput(out[i]);
+    }
+    prepare(tape);
+    for (auto& o : out) {
+        derivative(o) = 1.0;
+    }
+    tape.computeAdjoints();
+
+    std::vector<double> result;
+    for (auto& o : out) {
+        result.push_back(value(o));
+    }
+    for (auto& xi : x) {
+        result.push_back(derivative(xi));
+    }
+    for (auto& yi : y) {
+        result.push_back(derivative(yi));
+    }
+    tape.clearAll();
+    return result;
+}
+
+// Relative, so that results near zero are compared at full precision
+bool matches(double actual, double expected) {
+    return actual == expected || std::abs(actual - expected) <= 1e-13 * std::abs(expected);
+}
+
+bool testMathValues() {
+    std::cout << "\n=== Test 10: Math Function Values and Adjoints vs. XAD ===\n";
+
+    using tape_type = xad::adj<double>::tape_type;
+    using AD = MathAD;
+
+    // Near-zero and subnormal arguments catch cancellation and sign
+    // errors; equal arguments check the tie rules of abs, max and min
+    const double tiny = 5e-324;
+    const MathCheck checks[] = {
+        {"sinh", {-3.0, -1e-9, -1e-300, 0.0, tiny, 2.5}, {}, [](const AD& x, const AD&) { return sinh(x); }},
+        {"cosh", {-3.0, -1e-9, 0.0, tiny, 2.5}, {}, [](const AD& x, const AD&) { return cosh(x); }},
+        {"tanh", {-30.0, -1e-9, 0.0, 1e-300, 0.7, 25.0}, {}, [](const AD& x, const AD&) { return tanh(x); }},
+        {"acosh", {1.0 + 1e-9, 1.5, 100.0}, {}, [](const AD& x, const AD&) { return acosh(x); }},
+        {"atanh", {-0.9, -1e-9, 0.0, 1e-300, 0.5}, {}, [](const AD& x, const AD&) { return atanh(x); }},
+        {"log10", {1e-300, 0.5, 1.0, 7.3}, {}, [](const AD& x, const AD&) { return log10(x); }},
+        {"log2", {1e-300, 0.5, 1.0, 7.3}, {}, [](const AD& x, const AD&) { return log2(x); }},
+        {"exp2", {-30.0, -1e-9, 0.0, 3.5}, {}, [](const AD& x, const AD&) { return exp2(x); }},
+        {"cbrt", {-8.0, -1e-9, -tiny, 0.0, tiny, 1e-300, 27.0}, {}, [](const AD& x, const AD&) { return cbrt(x); }},
+        {"erf", {-2.0, -1e-9, 0.0, 1.5}, {}, [](const AD& x, const AD&) { return erf(x); }},
+        {"erfc", {-2.0, 0.0, 1e-9, 1.5}, {}, [](const AD& x, const AD&) { return erfc(x); }},
+        {"asin", {-0.9, -1e-9, 0.0, 0.5}, {}, [](const AD& x, const AD&) { return asin(x); }},
+        {"acos", {-0.9, 0.0, 1e-9, 0.5}, {}, [](const AD& x, const AD&) { return acos(x); }},
+        {"atan", {-10.0, -1e-9, 0.0, 2.0}, {}, [](const AD& x, const AD&) { return atan(x); }},
+        {"asinh", {-100.0, -1e-9, 0.0, 1e-300, 3.0}, {}, [](const AD& x, const AD&) { return asinh(x); }},
+        {"expm1", {-1.0, -1e-9, 0.0, 1e-300, 0.5}, {}, [](const AD& x, const AD&) { return expm1(x); }},
+        {"log1p", {-0.5, -1e-9, 0.0, 1e-300, 10.0}, {}, [](const AD& x, const AD&) { return log1p(x); }},
+        {"abs", {-2.0, -0.0, 0.0, tiny, 3.0}, {}, [](const AD& x, const AD&) { return abs(x); }},
+        {"max", {1.0, 0.0, -2.0, 3.0, tiny}, {1.0, 0.0, 3.0, -2.0, 0.0},
+         [](const AD& x, const AD& y) { return max(x, y); }},
+        {"min", {1.0, 0.0, -2.0, 3.0, tiny}, {1.0, 0.0, 3.0, -2.0, 0.0},
+         [](const AD& x, const AD& y) { return min(x, y); }},
+        {"atan2", {1.0, 1e-300, -1.0, 0.5}, {2.0, 1.0, -1e-9, -3.0},
+         [](const AD& y, const AD& x) { return atan2(y, x); }},
+        {"fmod", {7.5, -7.5, 1e-300, 3.0}, {2.0, 2.0, 1.0, 3.0},
+         [](const AD& a, const AD& b) { return fmod(a, b); }},
+    };
+
+    std::cout << "\nVerification:\n";
+    bool ok = true;
+    for (const MathCheck& c : checks) {
+        std::vector<double> expected;
+        {
+            tape_type tape;
+            expected = evaluateMath(tape, c, [](tape_type&) {});
+        }
+
+        // Fused forward and reverse, and forward() followed by a reverse sweep
+        for (const bool split : {false, true}) {
+            forge_xad::JITTape<tape_type> jit;
+            const std::vector<double> result =
+                evaluateMath(jit, c, [split](forge_xad::JITTape<tape_type>& tape) {
+                    if (split) {
+                        tape.forward();
+                    }
+                });
+            for (std::size_t k = 0; k < expected.size(); ++k) {
+                if (!matches(result[k], expected[k])) {
+                    const bool is_value = k < c.x.size();
+                    std::cout << "✗ " << c.name << (is_value ? " value " : " adjoint ") << k
+                              << ": " << std::setprecision(17) << result[k] << ", expected "
+                              << expected[k] << "\n";
+                    ok = false;
+                }
+            }
+        }
+    }
+    if (ok) {
+        std::cout << "✓ " << std::size(checks) << " math functions match XAD values and adjoints\n";
+    }
+    return ok;
+}
+
+bool testMaxMinTangents() {
+    std::cout << "\n=== Test 11: Max/Min Tangents (operand tangents 1 and 1e17) ===\n";
+
+    using mode = xad::adj<double>;
+    using tape_type = mode::tape_type;
+    using AD = mode::active_type;
+
+    tape_type tape;
+
+    AD x = 3.0, y = 1e-17;
+    tape.registerInput(x);
+    tape.registerInput(y);
+    tape.newRecording();
+
+    // The selected operand x has tangent 1, the other one 1e17
+    AD big = 1e17 * y;
+    AD z1 = max(x, big);
+    AD z2 = min(x - 2.5, big);
+    tape.registerOutput(z1);
+    tape.registerOutput(z2);
+
+    auto result = forge_xad::convertXadTapeToForge(tape);
+    forge_xad::TangentKernel kernel(result);
+    auto buffer = kernel.createBuffer();
+
+    const double inputs[] = {3.0, 1e-17};
+    const double direction[] = {1.0, 1.0};
+    double outputs[2], tangents[2];
+    kernel.execute(*buffer, inputs, direction, 1, outputs, tangents);
+
+    std::cout << "\nVerification:\n";
+    const bool ok = tangents[0] == 1.0 && tangents[1] == 1.0;
+    if (ok) {
+        std::cout << "✓ Selected tangents pass through exactly\n";
+    } else {
+        std::cout << "✗ Tangents " << tangents[0] << ", " << tangents[1] << ", expected 1, 1\n";
+    }
+    return ok;
+}
+
+bool testMaxMinHessian() {
+    std::cout << "\n=== Test 12: Hessian Through Max/Min (operand scales 1 and 1e17) ===\n";
+
+    using mode = xad::adj<double>;
+    using tape_type = mode::tape_type;
+    using AD = mode::active_type;
+
+    tape_type tape;
+
+    const double x0 = 3.0, y0 = 2.0;
+    AD x = x0, y = y0;
+    tape.registerInput(x);
+    tape.registerInput(y);
+    tape.newRecording();
+
+    // Both select their first operand: f = x^2 y + x y at (x0, y0)
+    AD steep = 1e17 * (y - y0);
+    AD f = max(x * x * y, steep + 5.0) + min(x * y, steep + 10.0);
+    tape.registerOutput(f);
+
+    auto result = forge_xad::convertXadTapeToForge(tape);
+    forge_xad::HessianKernel kernel(result);
+    auto buffer = kernel.createBuffer();
+
+    const double inputs[] = {x0, y0};
+    double hessian[4], gradient[2], output = 0.0;
+    kernel.computeHessian(*buffer, inputs, nullptr, hessian, gradient, &output);
+
+    const double expected_gradient[] = {2 * x0 * y0 + y0, x0 * x0 + x0};
+    const double expected_hessian[] = {2 * y0, 2 * x0 + 1, 2 * x0 + 1, 0.0};
+
+    std::cout << "\nVerification:\n";
+    bool ok = output == value(f);
+    for (int k = 0; k < 4; ++k) {
+        ok = ok && hessian[k] == expected_hessian[k];
+    }
+    for (int k = 0; k < 2; ++k) {
+        ok = ok && gradient[k] == expected_gradient[k];
+    }
+    if (ok) {
+        std::cout << "✓ Hessian and gradient follow the selected operands exactly\n";
+    } else {
+        std::cout << "✗ Hessian [" << hessian[0] << ", " << hessian[1] << "; " << hessian[2] << ", "
+                  << hessian[3] << "], gradient [" << gradient[0] << ", " << gradient[1]
+                  << "], expected [" << expected_hessian[0] << ", " << expected_hessian[1] << "; "
+                  << expected_hessian[2] << ", " << expected_hessian[3] << "], ["
+                  << expected_gradient[0] << ", " << expected_gradient[1] << "]\n";
+    }
+    return ok;
+}
+
 int main() {
     std::cout << "========================================\n";
     std::cout << "XAD Tape to Forge Graph Converter Tests\n";
@@ -266,6 +742,14 @@ int main() {
     all_passed &= testSimpleSubtraction();
     all_passed &= testNegation();
     all_passed &= testScalarMultiplication();
+    all_passed &= testConstantInterning();
+    all_passed &= testActivityPruning();
+    all_passed &= testTangentGraph();
+    all_passed &= testHessianKernel();
+    all_passed &= testMathFunctions();
+    all_passed &= testMathValues();
+    all_passed &= testMaxMinTangents();
+    all_passed &= testMaxMinHessian();
 
     std::cout << "\n========================================\n";
     if (all_passed) {
@@ -0,0 +1,134 @@
+/**
+ * @file vector_mode_example.cpp
+ * @brief Vector-adjoint tapes (xad::Tape<double, N>) on compiled kernels
+ *
+ * A small XVA-style netting set: several trade exposures are aggregated
+ * into a few outputs, and N adjoint directions (e.g. different output
+ * weightings) are propagated in one computeAdjoints() call. JITTape runs
+ * the directions on the AVX2 batch kernel, one direction per lane; the
+ * results are checked against a plain XAD vector tape for N = 2, 4, 8, 16.
+ *
+ * Usage: vector_mode_example [repetitions]   (default 1000)
+ */
+
+#include "forge_xad/jit_tape.hpp"
+#include <XAD/XAD.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+constexpr int kNumInputs = 6;
+constexpr int kNumOutputs = 3;
+
+// Three exposure profiles over a shared set of market inputs
+template<typename T>
+void exposures(const std::vector<T>& x, std::vector<T>& y) {
+    const T df = exp(-x[0] * x[1]);
+    const T fwd = x[2] * exp((x[0] - x[3]) * x[1]);
+    const T vol = x[4] * sqrt(x[1]);
+    y[0] = df * fwd * vol;
+    y[1] = df * log(fwd / x[5]) + vol * vol;
+    y[2] = y[0] * x[5] + df * x[3];
+}
+
+double seedOf(std::size_t direction, std::size_t output) {
+    return 1.0 + 0.25 * static_cast<double>(direction) - 0.5 * static_cast<double>(output);
+}
+
+const double kMarket[kNumInputs] = {0.03, 2.0, 100.0, 0.01, 0.25, 95.0};
+
+// One recorded iteration; returns the input adjoints, [N][numInputs]
+template<std::size_t N, class Tape>
+std::vector<double> sweep(Tape& tape, double bump) {
+    using AD = xad::AReal<double, N>;
+    std::vector<AD> x(kNumInputs);
+    for (int i = 0; i < kNumInputs; ++i) {
+        x[i] = kMarket[i] * (1.0 + bump);
+        tape.registerInput(x[i]);
+    }
+    tape.newRecording();
+    std::vector<AD> y(kNumOutputs);
+    exposures(x, y);
+    for (auto& out : y) {
+        tape.registerOutput(out);
+    }
+    for (std::size_t j = 0; j < y.size(); ++j) {
+        for (std::size_t d = 0; d < N; ++d) {
+            derivative(y[j])[d] = seedOf(d, j);
+        }
+    }
+    tape.computeAdjoints();
+
+    std::vector<double> adjoints(N * kNumInputs);
+    for (int i = 0; i < kNumInputs; ++i) {
+        for (std::size_t d = 0; d < N; ++d) {
+            adjoints[d * kNumInputs + i] = derivative(x[i])[d];
+        }
+    }
+    tape.clearAll();
+    return adjoints;
+}
+
+template<std::size_t N>
+bool check(int repetitions) {
+    using tape_type = typename xad::adj<double, N>::tape_type;
+
+    forge_xad::JITTape<tape_type> jit;
+    jit.deactivate();
+    tape_type reference(false);
+
+    double max_err = 0.0;
+    double jit_ms = 0.0, xad_ms = 0.0;
+    for (int rep = 0; rep < repetitions; ++rep) {
+        const double bump = 1e-4 * (rep % 17);
+
+        jit.activate();
+        auto t0 = Clock::now();
+        const std::vector<double> a = sweep<N>(jit, bump);
+        jit_ms += std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        jit.deactivate();
+
+        reference.activate();
+        t0 = Clock::now();
+        const std::vector<double> b = sweep<N>(reference, bump);
+        xad_ms += std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        reference.deactivate();
+
+        for (std::size_t k = 0; k < a.size(); ++k) {
+            max_err = std::max(max_err, std::abs(a[k] - b[k]));
+        }
+    }
+
+    std::cout << "  N = " << std::setw(2) << N
+              << "  JIT " << std::setw(8) << jit_ms << " ms"
+              << "  XAD " << std::setw(8) << xad_ms << " ms"
+              << "  max abs error " << std::scientific << max_err << std::fixed << "\n";
+    return max_err < 1e-10;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int repetitions = argc > 1 ? std::atoi(argv[1]) : 1000;
+
+    std::cout << "========================================\n";
+    std::cout << "Vector-Mode Adjoints (Tape<double, N>)\n";
+    std::cout << "========================================\n\n";
+    std::cout << std::fixed << std::setprecision(3);
+
+    bool ok = check<2>(repetitions);
+    ok = check<4>(repetitions) && ok;
+    ok = check<8>(repetitions) && ok;
+    ok = check<16>(repetitions) && ok;
+
+    std::cout << (ok ? "\n✓ All directions match XAD\n" : "\n✗ Mismatch against XAD\n");
+    return ok ? 0 : 1;
+}
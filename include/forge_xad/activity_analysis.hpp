@@ -0,0 +1,30 @@
+#pragma once
+
+#include <graph/graph.hpp>
+#include <cstddef>
+
+namespace forge_xad {
+
+/**
+ * @brief Result of analyzeActivity()
+ */
+struct ActivityStats {
+    /// Nodes newly marked isDead (no path to any output)
+    std::size_t deadNodes = 0;
+    /// Live nodes whose needsGradient flag was cleared
+    std::size_t gradientsCleared = 0;
+};
+
+/**
+ * @brief Prune nodes and adjoints that cannot contribute to the result
+ *
+ * Reverse reachability from graph.outputs marks every node that no output
+ * depends on as isDead (Input nodes are kept so they can still be bound).
+ * needsGradient is then recomputed as "live and depends on a diff input",
+ * so adjoints are only propagated along paths that connect an output to a
+ * differentiated input (diff inputs themselves keep the flag). Safe to
+ * run repeatedly, e.g. after optimizeGraph().
+ */
+ActivityStats analyzeActivity(forge::Graph& graph);
+
+} // namespace forge_xad
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "forge_xad/sparse_jacobian.hpp"
+#include "forge_xad/xad_tape_converter.hpp"
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace forge_xad {
+
+/**
+ * @brief AVX2 (4-lane) kernel that prices many input sets per call
+ *
+ * Compiles a converted graph with the AVX2 instruction set so that one
+ * kernel execution evaluates values and adjoints for 4 scenarios at once.
+ * Inputs, outputs and gradients are exchanged in structure-of-arrays form:
+ * all scenarios of input 0, then all scenarios of input 1, and so on.
+ *
+ * The kernel itself is read-only after construction; all mutable state
+ * lives in the buffer returned by createBuffer(), so one BatchKernel can
+ * be shared by several threads as long as each uses its own buffer.
+ */
+class BatchKernel {
+public:
+    /// Number of scenarios evaluated by one kernel execution
+    static constexpr std::size_t LANES = 4;
+
+    /**
+     * @brief Compile the graph of a conversion result for AVX2
+     *
+     * @throws std::exception if Forge fails to compile the graph
+     */
+    explicit BatchKernel(const ConversionResult& conversion);
+
+    /**
+     * @brief Create a value/gradient buffer sized for this kernel
+     */
+    std::unique_ptr<forge::INodeValueBuffer> createBuffer() const;
+
+    /**
+     * @brief Evaluate numScenarios input sets
+     *
+     * Scenario s of input i is read from inputs[i * stride + s]; outputs
+     * and input gradients are written with the same layout. When
+     * numScenarios is not a multiple of LANES, the unused lanes of the last
+     * batch repeat the last scenario and their results are discarded.
+     *
+     * @param buffer Buffer from createBuffer() (one per thread)
+     * @param numScenarios Number of input sets to evaluate
+     * @param inputs Input values, [numInputs][stride]
+     * @param outputs Output values, [numOutputs][stride] (may be nullptr)
+     * @param inputGradients Input adjoints, [numInputs][stride] (may be nullptr)
+     * @param outputSeeds Adjoint seed per output (nullptr seeds all outputs with 1.0)
+     * @param stride Distance between consecutive inputs (0 means numScenarios)
+     */
+    void execute(forge::INodeValueBuffer& buffer, std::size_t numScenarios,
+                 const double* inputs, double* outputs, double* inputGradients,
+                 const double* outputSeeds = nullptr, std::size_t stride = 0) const;
+
+    /**
+     * @brief Single-precision variant of execute()
+     *
+     * Scenario data is stored as float, which halves the memory traffic
+     * of large Monte Carlo batches. The kernel still computes in double:
+     * inputs are widened when loaded into the lanes and results are
+     * rounded to float when stored.
+     */
+    void execute(forge::INodeValueBuffer& buffer, std::size_t numScenarios,
+                 const float* inputs, float* outputs, float* inputGradients,
+                 const double* outputSeeds = nullptr, std::size_t stride = 0) const;
+
+    /**
+     * @brief Evaluate numScenarios input sets and sum the results
+     *
+     * Same as execute(), but instead of storing per-scenario results the
+     * outputs and input gradients are added to outputSums[numOutputs] and
+     * gradientSums[numInputs]. Tail lanes are not included in the sums.
+     */
+    void executeReduced(forge::INodeValueBuffer& buffer, std::size_t numScenarios,
+                        const double* inputs, double* outputSums, double* gradientSums,
+                        const double* outputSeeds = nullptr, std::size_t stride = 0) const;
+
+    /// executeReduced() on float scenario inputs; the sums stay in double
+    void executeReduced(forge::INodeValueBuffer& buffer, std::size_t numScenarios,
+                        const float* inputs, double* outputSums, double* gradientSums,
+                        const double* outputSeeds = nullptr, std::size_t stride = 0) const;
+
+    /**
+     * @brief Dense Jacobian of all outputs with respect to all inputs
+     *
+     * Broadcasts one input set to every lane and gives each lane a unit
+     * seed for a different output, so one kernel execution yields LANES
+     * Jacobian rows. Forge kernels fuse the forward and reverse sweeps,
+     * so the forward pass runs once per group of LANES outputs (vectorised)
+     * rather than once per output.
+     *
+     * @param buffer Buffer from createBuffer()
+     * @param inputs Input values, [numInputs]
+     * @param jacobian Row-major result, [numOutputs][numInputs]
+     * @param outputs Output values, [numOutputs] (may be nullptr)
+     */
+    void computeJacobian(forge::INodeValueBuffer& buffer, const double* inputs,
+                         double* jacobian, double* outputs = nullptr) const;
+
+    /**
+     * @brief Reverse sweeps for several adjoint directions at one input set
+     *
+     * The vector-mode counterpart of a scalar reverse sweep: direction d
+     * seeds the outputs with seeds[d * numOutputs + j] and runs in its own
+     * lane, so LANES directions share one kernel execution.
+     *
+     * @param buffer Buffer from createBuffer()
+     * @param inputs Input values, [numInputs]
+     * @param seeds Output adjoints, [numDirections][numOutputs]
+     * @param numDirections Number of adjoint directions
+     * @param inputGradients Input adjoints, [numDirections][numInputs]
+     * @param outputs Output values, [numOutputs] (may be nullptr)
+     */
+    void computeAdjointDirections(forge::INodeValueBuffer& buffer, const double* inputs,
+                                  const double* seeds, std::size_t numDirections,
+                                  double* inputGradients, double* outputs = nullptr) const;
+
+    /**
+     * @brief Sparse Jacobian with one reverse sweep per output colour
+     *
+     * Like computeJacobian(), but each lane seeds all outputs of one colour
+     * (see colourJacobian()), so the number of sweeps falls from
+     * numOutputs to numColours, LANES of them per kernel call.
+     *
+     * @param buffer Buffer from createBuffer()
+     * @param inputs Input values, [numInputs]
+     * @param colouring Pattern and colouring from colourJacobian()
+     * @param jacobian Result; structure copied from the colouring
+     * @param outputs Output values, [numOutputs] (may be nullptr)
+     */
+    void computeSparseJacobian(forge::INodeValueBuffer& buffer, const double* inputs,
+                               const JacobianColouring& colouring, SparseJacobian& jacobian,
+                               double* outputs = nullptr) const;
+
+    std::size_t numInputs() const { return input_nodes_.size(); }
+    std::size_t numOutputs() const { return output_nodes_.size(); }
+
+private:
+    template<class Scalar>
+    void executeImpl(forge::INodeValueBuffer& buffer, std::size_t numScenarios,
+                     const Scalar* inputs, Scalar* outputs, Scalar* inputGradients,
+                     const double* outputSeeds, std::size_t stride) const;
+
+    template<class Scalar>
+    void executeReducedImpl(forge::INodeValueBuffer& buffer, std::size_t numScenarios,
+                            const Scalar* inputs, double* outputSums, double* gradientSums,
+                            const double* outputSeeds, std::size_t stride) const;
+
+    // Load one batch of scenarios into the buffer and run the kernel
+    template<class Scalar>
+    void runBatch(forge::INodeValueBuffer& buffer, std::size_t base, std::size_t count,
+                  const Scalar* inputs, std::size_t stride, const double* outputSeeds,
+                  bool wantGradients) const;
+
+    forge::Graph graph_;
+    std::vector<forge::NodeId> input_nodes_;
+    std::vector<forge::NodeId> output_nodes_;
+    std::unique_ptr<forge::StitchedKernel> kernel_;
+};
+
+} // namespace forge_xad
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <compiler/compiler_config.hpp>
+#include <cstddef>
+
+namespace forge_xad {
+
+/**
+ * @brief What JITTape knows about a recording shape when deciding
+ *
+ * Times are measured by JITTape; zero means "not measured yet".
+ */
+struct TapeProfile {
+    std::size_t numStatements = 0;  // getNumStatements() of the recording
+    std::size_t directions = 1;     // adjoint directions per sweep (vector mode)
+    std::size_t evaluations = 0;    // computeAdjoints() calls so far, this one included
+    double tapeMs = 0.0;            // mean tape computeAdjoints() time of this shape
+};
+
+struct CompilationDecision {
+    using InstructionSet = forge::CompilerConfig::InstructionSet;
+
+    bool compile = false;
+    /// SSE2_SCALAR: one sweep per direction; AVX2_PACKED: one direction per lane
+    InstructionSet instructionSet = InstructionSet::SSE2_SCALAR;
+};
+
+/**
+ * @brief Decides per recording shape whether, and for what, to compile
+ *
+ * JITTape asks decide() before every computeAdjoints() of a shape that is
+ * still interpreted, and reports what it measures through the observe
+ * callbacks, so a policy can calibrate itself. A policy object can be
+ * shared by several tapes of the same thread.
+ */
+class CompilationPolicy {
+public:
+    using InstructionSet = CompilationDecision::InstructionSet;
+
+    virtual ~CompilationPolicy() = default;
+
+    virtual CompilationDecision decide(const TapeProfile& profile) = 0;
+
+    /// Conversion plus compilation of one shape
+    virtual void observeCompilation(const TapeProfile& /*profile*/, InstructionSet /*instructionSet*/,
+                                    double /*ms*/) {}
+
+    /// One computeAdjoints() on a compiled kernel
+    virtual void observeKernelRun(const TapeProfile& /*profile*/, InstructionSet /*instructionSet*/,
+                                  double /*ms*/) {}
+
+    /// One computeAdjoints() on the tape
+    virtual void observeTapeRun(const TapeProfile& /*profile*/, double /*ms*/) {}
+};
+
+/// Compile on first use (JITTape's behaviour without a policy)
+class AlwaysCompilePolicy : public CompilationPolicy {
+public:
+    CompilationDecision decide(const TapeProfile& profile) override;
+};
+
+/// Stay on the tape
+class NeverCompilePolicy : public CompilationPolicy {
+public:
+    CompilationDecision decide(const TapeProfile& profile) override;
+};
+
+/// Compile once a shape has been evaluated a fixed number of times
+class ReuseThresholdPolicy : public CompilationPolicy {
+public:
+    explicit ReuseThresholdPolicy(std::size_t threshold) : threshold_(threshold) {}
+
+    CompilationDecision decide(const TapeProfile& profile) override;
+
+private:
+    std::size_t threshold_;
+};
+
+/**
+ * @brief Compile when the predicted saving pays for the compilation
+ *
+ * Following the usual tiered-JIT assumption, a shape evaluated n times so
+ * far is expected to be evaluated reuseFactor * n more times. It is
+ * compiled once
+ *
+ *   reuseFactor * n * (tapeMs - kernelMs) > compileMs
+ *
+ * where compileMs and kernelMs are estimated per statement of the
+ * recording. kernelMs is estimated for both instruction sets (the packed
+ * one runs ceil(directions / 4) sweeps, the scalar one `directions`
+ * sweeps) and the cheaper is chosen. All per-statement rates start at the
+ * Options values and then follow the measurements (exponential moving
+ * average); tapeMs is the shape's own measurement when there is one.
+ */
+class CostModelPolicy : public CompilationPolicy {
+public:
+    struct Options {
+        double reuseFactor = 1.0;
+        double compileMsPerStatement = 2e-3;       // conversion + optimizer + code generation
+        double tapeMsPerStatement = 2e-5;
+        double scalarKernelMsPerStatement = 2e-6;  // per sweep
+        double packedKernelMsPerStatement = 3e-6;  // per sweep of 4 lanes
+        double smoothing = 0.3;                    // weight of a new measurement
+    };
+
+    CostModelPolicy() : CostModelPolicy(Options()) {}
+    explicit CostModelPolicy(const Options& options);
+
+    CompilationDecision decide(const TapeProfile& profile) override;
+
+    void observeCompilation(const TapeProfile& profile, InstructionSet instructionSet, double ms) override;
+    void observeKernelRun(const TapeProfile& profile, InstructionSet instructionSet, double ms) override;
+    void observeTapeRun(const TapeProfile& profile, double ms) override;
+
+    /// Current (calibrated) rates
+    const Options& rates() const { return rates_; }
+
+    /// Estimated computeAdjoints() time of a compiled kernel
+    double predictKernelMs(const TapeProfile& profile, InstructionSet instructionSet) const;
+
+private:
+    static std::size_t sweeps(const TapeProfile& profile, InstructionSet instructionSet);
+    void blend(double& rate, double measured) const;
+
+    Options rates_;
+};
+
+} // namespace forge_xad
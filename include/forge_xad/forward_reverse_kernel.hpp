@@ -0,0 +1,64 @@
+#pragma once
+
+#include "forge_xad/graph_transforms.hpp"
+#include "forge_xad/xad_tape_converter.hpp"
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace forge_xad {
+
+/**
+ * @brief Separately compiled forward and reverse sweeps
+ *
+ * A fused Forge kernel recomputes the forward pass on every execution.
+ * Here the forward pass is the primal kernel (makePrimalGraph()) and the
+ * reverse pass is a forward-only kernel over makeAdjointGraph(). Both use
+ * one SSE2 scalar buffer: primal nodes keep their IDs in the adjoint
+ * graph, so forward() leaves exactly the values reverse() reads, and
+ * reverse() can then run any number of times with different seeds.
+ *
+ * As with the other kernels, mutable state lives in the buffer.
+ */
+class ForwardReverseKernel {
+public:
+    /**
+     * @throws std::exception if the graph has no adjoint rule or fails to compile
+     */
+    explicit ForwardReverseKernel(const ConversionResult& conversion);
+
+    /// Buffer shared by both kernels (sized for the adjoint graph)
+    std::unique_ptr<forge::INodeValueBuffer> createBuffer() const;
+
+    /**
+     * @brief Evaluate the function and keep all intermediate values
+     *
+     * @param buffer Buffer from createBuffer()
+     * @param inputs Input values, [numInputs]
+     * @param outputs Output values, [numOutputs] (may be nullptr)
+     */
+    void forward(forge::INodeValueBuffer& buffer, const double* inputs, double* outputs) const;
+
+    /**
+     * @brief Reverse sweep over the values of the last forward()
+     *
+     * @param seeds Output adjoints, [numOutputs] (nullptr seeds all outputs with 1.0)
+     * @param inputGradients Input adjoints, [numInputs]; value-only inputs get 0
+     */
+    void reverse(forge::INodeValueBuffer& buffer, const double* seeds, double* inputGradients) const;
+
+    std::size_t numInputs() const { return input_nodes_.size(); }
+    std::size_t numOutputs() const { return output_nodes_.size(); }
+
+private:
+    forge::Graph primal_;
+    AdjointGraph adjoint_;
+    std::vector<forge::NodeId> input_nodes_;
+    std::vector<forge::NodeId> output_nodes_;
+    std::unique_ptr<forge::StitchedKernel> forward_kernel_;
+    std::unique_ptr<forge::StitchedKernel> reverse_kernel_;
+};
+
+} // namespace forge_xad
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "forge_xad/xad_tape_converter.hpp"
+#include <graph/graph.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace forge_xad {
+
+/**
+ * @brief How JITTape runs a converted graph
+ */
+enum class ExecutionBackend {
+    Compiled,     // Forge native code (ForgeEngine::compile)
+    Interpreter,  // GraphInterpreter bytecode, no code generation
+};
+
+/**
+ * @brief Bytecode interpreter for converted graphs (forward and reverse)
+ *
+ * The constructor lowers the (optimized, activity-analysed) graph into
+ * two flat instruction streams over dense value slots: the forward stream
+ * holds every live operation, the reverse stream only those whose operands
+ * need a gradient, already in sweep order. Dead nodes and inactive
+ * branches are dropped. Building is linear in the graph size, so there is
+ * no compile latency to amortise.
+ *
+ * A Workspace holds `lanes` values per slot (slot s, lane l at s * lanes + l).
+ * Each instruction loops over the lanes with a compile-time trip count,
+ * which the compiler vectorizes, so a LANES-wide workspace evaluates LANES
+ * scenarios for roughly the dispatch cost of one. Adjoint rules match
+ * makeAdjointGraph(), including XAD's tie rules for Abs, Max and Min.
+ *
+ * The interpreter itself is immutable; as with BatchKernel, threads can
+ * share one interpreter with their own workspaces.
+ */
+class GraphInterpreter {
+public:
+    /// Scenarios per instruction in a batch workspace
+    static constexpr std::size_t LANES = 4;
+
+    struct Workspace {
+        std::size_t lanes = 1;
+        std::vector<double> values;
+        std::vector<double> adjoints;
+    };
+
+    /**
+     * @throws std::runtime_error for opcodes without an interpreter rule
+     */
+    explicit GraphInterpreter(const ConversionResult& conversion);
+
+    /**
+     * @param lanes 1 for single input sets, LANES for execute()
+     */
+    Workspace createWorkspace(std::size_t lanes = 1) const;
+
+    /**
+     * @brief Forward pass only
+     *
+     * @param inputs Input values, [numInputs]
+     * @param outputs Output values, [numOutputs]
+     */
+    void evaluate(Workspace& workspace, const double* inputs, double* outputs) const;
+
+    /**
+     * @brief One forward pass, then one reverse sweep per direction
+     *
+     * The values stay in the workspace between sweeps, so extra
+     * directions cost only the reverse stream (numDirections / lanes
+     * sweeps in a wide workspace).
+     *
+     * @param inputs Input values, [numInputs]
+     * @param seeds Output adjoints, [numDirections][numOutputs] (nullptr seeds all with 1.0)
+     * @param numDirections Number of directions
+     * @param inputGradients Input adjoints, [numDirections][numInputs] (may be nullptr)
+     * @param outputs Output values, [numOutputs] (may be nullptr)
+     */
+    void computeAdjointDirections(Workspace& workspace, const double* inputs, const double* seeds,
+                                  std::size_t numDirections, double* inputGradients,
+                                  double* outputs = nullptr) const;
+
+    /// computeAdjointDirections() for a single direction
+    void computeAdjoints(Workspace& workspace, const double* inputs, const double* seeds,
+                         double* inputGradients, double* outputs = nullptr) const {
+        computeAdjointDirections(workspace, inputs, seeds, 1, inputGradients, outputs);
+    }
+
+    /**
+     * @brief Values and adjoints for many input sets, one per lane
+     *
+     * Same structure-of-arrays layout as BatchKernel::execute().
+     *
+     * @param outputSeeds Adjoint seed per output (nullptr seeds all outputs with 1.0)
+     */
+    void execute(Workspace& workspace, std::size_t numScenarios, const double* inputs,
+                 double* outputs, double* inputGradients, const double* outputSeeds = nullptr) const;
+
+    std::size_t numInputs() const { return input_slots_.size(); }
+    std::size_t numOutputs() const { return output_slots_.size(); }
+    std::size_t numForwardInstructions() const { return forward_.size(); }
+    std::size_t numReverseInstructions() const { return reverse_.size(); }
+
+private:
+    struct Instruction {
+        forge::OpCode op;
+        std::uint8_t gradA;  // operand a needs its adjoint
+        std::uint8_t gradB;
+        std::uint32_t dst;
+        std::uint32_t a;
+        std::uint32_t b;
+    };
+
+    template<std::size_t W>
+    void runForward(double* values) const;
+
+    template<std::size_t W>
+    void runReverse(const double* values, double* adjoints) const;
+
+    void forward(Workspace& workspace) const;
+    void reverse(Workspace& workspace) const;
+
+    std::size_t num_slots_ = 0;
+    std::vector<Instruction> forward_;
+    std::vector<Instruction> reverse_;
+    std::vector<std::uint32_t> constant_slots_;
+    std::vector<double> constant_values_;
+    std::vector<std::uint32_t> input_slots_;
+    std::vector<std::uint32_t> output_slots_;
+    std::vector<bool> differentiable_;  // per input
+};
+
+} // namespace forge_xad
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "forge_xad/xad_tape_converter.hpp"
+#include <graph/graph.hpp>
+#include <cstddef>
+
+namespace forge_xad {
+
+/**
+ * @brief Switches for the bridge-side graph passes
+ */
+struct GraphOptimizerOptions {
+    /// Evaluate nodes whose operands are all constants
+    bool constantFolding = true;
+    /// Merge nodes with identical (op, a, b), Add and Mul operands sorted
+    bool commonSubexpressionElimination = true;
+    /// x*1, x+0, x-0, x/1, x-x, -(-x), plus x*x -> Square, 1/x -> Recip, pow(x,2|-1|1)
+    bool algebraicSimplification = true;
+
+    static GraphOptimizerOptions None() {
+        GraphOptimizerOptions options;
+        options.constantFolding = false;
+        options.commonSubexpressionElimination = false;
+        options.algebraicSimplification = false;
+        return options;
+    }
+};
+
+/**
+ * @brief Per-pass effect of optimizeGraph()
+ *
+ * Counts are nodes whose computation was removed: folded into a
+ * constant, merged into an equal node, or replaced by an operand.
+ * Canonicalisations that keep a node (x*x -> Square) are counted
+ * separately.
+ */
+struct GraphOptimizerStats {
+    std::size_t constantsFolded = 0;
+    std::size_t subexpressionsEliminated = 0;
+    std::size_t simplified = 0;
+    std::size_t canonicalized = 0;
+
+    std::size_t nodesRemoved() const {
+        return constantsFolded + subexpressionsEliminated + simplified;
+    }
+};
+
+/**
+ * @brief Optimize a converted graph in place before compilation
+ *
+ * Runs a single forward sweep over the (topologically ordered) nodes and
+ * applies the enabled passes to each node in turn: constant folding,
+ * algebraic simplification, then CSE. Node IDs are preserved - removed
+ * nodes are marked isDead and their users, the graph outputs and the
+ * conversion's output/slot mappings and host node operands are redirected
+ * to the replacement. Input nodes are never touched.
+ *
+ * Note: x - x is folded to 0 even for non-finite x.
+ */
+GraphOptimizerStats optimizeGraph(ConversionResult& conversion,
+                                  const GraphOptimizerOptions& options = GraphOptimizerOptions());
+
+} // namespace forge_xad
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "forge_xad/xad_tape_converter.hpp"
+#include <graph/graph.hpp>
+#include <vector>
+
+namespace forge_xad {
+
+/**
+ * @brief Copy of a graph with the reverse sweep stripped out
+ *
+ * Clears diff_inputs and every needsGradient flag, so Forge compiles a
+ * forward-only (primal) kernel that neither reads nor writes gradients.
+ * Node IDs are unchanged, so input/output mappings of the source graph
+ * apply to the copy.
+ */
+forge::Graph makePrimalGraph(const forge::Graph& graph);
+
+/**
+ * @brief Copy of a graph whose reverse sweep stops at a node boundary
+ *
+ * Every live, non-constant node with ID below boundary becomes a
+ * differentiable Input, so the compiled kernel recomputes only the suffix
+ * (IDs >= boundary) from externally supplied prefix values and leaves the
+ * adjoints of the prefix nodes in the gradient buffer. Node IDs are
+ * unchanged. Used for partial adjoints down to a tape position.
+ */
+forge::Graph makeSuffixGraph(const forge::Graph& graph, forge::NodeId boundary);
+
+/**
+ * @brief Forward-mode (tangent) graph derived from a converted graph
+ *
+ * Values and one tangent direction are computed side by side; the graph
+ * has no diff inputs, so Forge compiles it forward-only.
+ */
+struct TangentGraph {
+    forge::Graph graph;
+    /// Input node that receives the tangent seed of input i
+    std::vector<forge::NodeId> input_tangents;
+    /// Node that holds the tangent of output j
+    std::vector<forge::NodeId> output_tangents;
+};
+
+/**
+ * @brief Append the tangent of every live node to a copy of the graph
+ *
+ * Original node IDs are unchanged; each input gets an extra Input node for
+ * its tangent, and every node depending on an input gets a tangent node
+ * built from the usual forward rules (constants have no tangent). Abs, Max
+ * and Min follow XAD: abs' is +1 at x == 0, and Max (Min) takes the whole
+ * tangent of a when a >= b (a <= b), so ties pick a instead of averaging.
+ */
+TangentGraph makeTangentGraph(const ConversionResult& conversion);
+
+/**
+ * @brief Tangent graph prepared for a reverse sweep (second order)
+ *
+ * makeTangentGraph() with every differentiable input and its tangent input
+ * marked as diff inputs. Seeding the output tangents with weights w and
+ * sweeping back gives, for the tangent direction v, sum_j w_j H_j v in the
+ * adjoints of the inputs and the first-order w^T J in the adjoints of the
+ * tangent inputs. Tangent inputs of value-only inputs stay plain inputs.
+ */
+TangentGraph makeHessianGraph(const ConversionResult& conversion);
+
+/**
+ * @brief Explicit reverse sweep of a converted graph
+ *
+ * Every live primal node keeps its ID but becomes an Input, so its value
+ * is read from a buffer filled by the forward (primal) kernel. The
+ * adjoint of each node is appended as ordinary forward-only nodes, one
+ * seed Input per output, and the adjoint of input i ends up in
+ * input_adjoints[i] (a constant 0 for value-only inputs). Compiled
+ * without diff inputs, this is a reverse kernel that can run many times
+ * on one forward pass.
+ */
+struct AdjointGraph {
+    forge::Graph graph;
+    /// Input node that receives the adjoint seed of output j
+    std::vector<forge::NodeId> output_seeds;
+    /// Node that holds the adjoint of input i
+    std::vector<forge::NodeId> input_adjoints;
+};
+
+/**
+ * @brief Build the reverse sweep of a converted graph
+ *
+ * Uses the same rules as makeTangentGraph(), transposed; Abs, Max and Min
+ * share its tie rules. Only nodes with needsGradient propagate.
+ */
+AdjointGraph makeAdjointGraph(const ConversionResult& conversion);
+
+} // namespace forge_xad
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "forge_xad/graph_transforms.hpp"
+#include "forge_xad/xad_tape_converter.hpp"
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace forge_xad {
+
+/**
+ * @brief Compiled second-order kernel (reverse sweep over the tangent graph)
+ *
+ * Compiles makeHessianGraph() with the AVX2 instruction set. All lanes
+ * share the same input values and each lane carries one tangent direction
+ * v, so one kernel execution yields LANES Hessian-vector products together
+ * with the gradient. A dense Hessian of n inputs takes ceil(n / LANES)
+ * executions, with no re-recording between input sets.
+ *
+ * For several outputs the products are of the weighted Hessian
+ * sum_j w_j H_j; with the default weights of 1 this is the Hessian of the
+ * sum of all outputs. As with BatchKernel, mutable state lives in the
+ * buffer, so one kernel can be shared by threads with their own buffers.
+ */
+class HessianKernel {
+public:
+    /// Tangent directions propagated by one kernel execution
+    static constexpr std::size_t LANES = 4;
+
+    /**
+     * @throws std::exception if the graph has no tangent rule or fails to compile
+     */
+    explicit HessianKernel(const ConversionResult& conversion);
+
+    std::unique_ptr<forge::INodeValueBuffer> createBuffer() const;
+
+    /**
+     * @brief Hessian-vector products for numDirections directions
+     *
+     * @param buffer Buffer from createBuffer()
+     * @param inputs Input values, [numInputs]
+     * @param directions Tangent directions, [numDirections][numInputs]
+     * @param numDirections Number of directions
+     * @param outputWeights Weight per output (nullptr weights all outputs with 1.0)
+     * @param products H v per direction, [numDirections][numInputs]
+     * @param gradient Weighted gradient w^T J, [numInputs] (may be nullptr)
+     * @param outputs Output values, [numOutputs] (may be nullptr)
+     */
+    void hessianVectorProducts(forge::INodeValueBuffer& buffer, const double* inputs,
+                               const double* directions, std::size_t numDirections,
+                               const double* outputWeights, double* products,
+                               double* gradient = nullptr, double* outputs = nullptr) const;
+
+    /**
+     * @brief Dense Hessian, one unit direction per input
+     *
+     * Row i holds H e_i. Value-only inputs get zero rows and columns.
+     *
+     * @param hessian Row-major result, [numInputs][numInputs]
+     */
+    void computeHessian(forge::INodeValueBuffer& buffer, const double* inputs,
+                        const double* outputWeights, double* hessian,
+                        double* gradient = nullptr, double* outputs = nullptr) const;
+
+    std::size_t numInputs() const { return input_nodes_.size(); }
+    std::size_t numOutputs() const { return output_nodes_.size(); }
+
+private:
+    TangentGraph hessian_;
+    std::vector<forge::NodeId> input_nodes_;
+    std::vector<forge::NodeId> output_nodes_;
+    std::vector<bool> differentiable_;  // per input
+    std::unique_ptr<forge::StitchedKernel> kernel_;
+};
+
+} // namespace forge_xad
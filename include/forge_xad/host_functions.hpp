@@ -0,0 +1,61 @@
+#pragma once
+
+#include <XAD/XAD.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+namespace forge_xad {
+
+/**
+ * @brief Host-side evaluation of an operation Forge cannot compile
+ *
+ * value() computes the result from the operand values; partials() writes
+ * d result / d operand k for every operand, given the operands and the
+ * result value. Both run on the calling thread between compiled segments
+ * (see HybridKernel).
+ */
+struct HostFunction {
+    std::size_t arity = 1;
+    std::function<double(const double* args)> value;
+    std::function<void(const double* args, double result, double* partials)> partials;
+};
+
+/**
+ * @brief Host functions by XAD opcode
+ *
+ * Passed to the converter through ConversionOptions::hostFunctions. A
+ * tape statement whose opcode Forge does not support, but which has an
+ * entry here with a matching operand count, becomes a host node instead
+ * of failing the conversion.
+ */
+class HostFunctionRegistry {
+public:
+    void add(xad::OpCode opcode, HostFunction function);
+
+    /// nullptr if the opcode has no host function
+    const HostFunction* find(xad::OpCode opcode) const;
+
+    std::size_t size() const { return functions_.size(); }
+
+private:
+    std::unordered_map<std::uint16_t, HostFunction> functions_;
+};
+
+/**
+ * @brief Host functions for XAD math opcodes the converter cannot lower
+ *
+ * Erf, Erfc, Sinh, Cosh, Tanh, Asin, Acos, Atan, Asinh, Acosh, Atanh,
+ * Expm1, Log1p (unary) and Atan2, Fmod (binary), evaluated with the
+ * <cmath> functions XAD itself uses and XAD's adjoint rules. The other
+ * math opcodes (Log10, Log2, Exp2, Cbrt) are expanded into Forge
+ * primitives by the converter and compile natively; the hyperbolic ones
+ * lose precision near 0 (acosh near 1) in primitive form. JITTape uses
+ * this registry unless setHostFunctions() replaces it; copy it to add
+ * functions of your own.
+ */
+std::shared_ptr<const HostFunctionRegistry> builtinHostFunctions();
+
+} // namespace forge_xad
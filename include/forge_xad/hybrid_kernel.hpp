@@ -0,0 +1,130 @@
+#pragma once
+
+#include "forge_xad/forward_reverse_kernel.hpp"
+#include "forge_xad/host_functions.hpp"
+#include "forge_xad/xad_tape_converter.hpp"
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace forge_xad {
+
+/**
+ * @brief How much of a hybrid graph runs as native code
+ */
+struct HybridStats {
+    std::size_t compiledNodes = 0;  // live operations inside compiled segments
+    std::size_t hostNodes = 0;      // host function calls
+    std::size_t segments = 0;       // compiled segments
+
+    double compiledShare() const {
+        const std::size_t total = compiledNodes + hostNodes;
+        return total > 0 ? static_cast<double>(compiledNodes) / static_cast<double>(total) : 1.0;
+    }
+};
+
+/**
+ * @brief Compiled segments joined by host function calls
+ *
+ * For a conversion with host nodes (ConversionOptions::hostFunctions).
+ * Every live operation is assigned a stage: the number of host calls on
+ * its longest path from the inputs. The operations of one stage form a
+ * segment, compiled as a ForwardReverseKernel whose inputs are the values
+ * it reads from earlier stages and whose outputs are the values later
+ * stages, host calls or the final outputs read. Host calls of stage s
+ * depend only on earlier stages, so a forward pass alternates between the
+ * host calls and the segment of each stage; the reverse pass runs the
+ * same steps backwards, passing adjoints through the host partials.
+ *
+ * Values and adjoints cross the boundaries through node-ID indexed tables
+ * in the Workspace, which also holds the segment buffers. As with the
+ * other kernels, the HybridKernel itself is read-only after construction.
+ */
+class HybridKernel {
+public:
+    struct Workspace {
+        std::vector<double> values;    // by node ID of the converted graph
+        std::vector<double> adjoints;
+        std::vector<std::unique_ptr<forge::INodeValueBuffer>> buffers;  // per segment
+        std::vector<double> in;        // scratch for segment and host calls
+        std::vector<double> out;
+    };
+
+    /**
+     * @param conversion Optimized, activity-analysed conversion with host nodes
+     * @param functions Host function for every host node (copied)
+     * @throws std::runtime_error if a host node has no matching function
+     * @throws std::exception if a segment fails to compile
+     */
+    HybridKernel(const ConversionResult& conversion, const HostFunctionRegistry& functions);
+
+    Workspace createWorkspace() const;
+
+    /**
+     * @brief Evaluate the function and keep all values for reverse()
+     *
+     * @param inputs Input values, [numInputs]
+     * @param outputs Output values, [numOutputs] (may be nullptr)
+     */
+    void forward(Workspace& workspace, const double* inputs, double* outputs) const;
+
+    /**
+     * @brief Reverse sweep over the values of the last forward()
+     *
+     * @param seeds Output adjoints, [numOutputs] (nullptr seeds all outputs with 1.0)
+     * @param inputGradients Input adjoints, [numInputs]; value-only inputs get 0
+     */
+    void reverse(Workspace& workspace, const double* seeds, double* inputGradients) const;
+
+    /// forward() only
+    void evaluate(Workspace& workspace, const double* inputs, double* outputs) const {
+        forward(workspace, inputs, outputs);
+    }
+
+    /**
+     * @brief One forward pass, then one reverse sweep per direction
+     *
+     * Same layout as GraphInterpreter::computeAdjointDirections().
+     */
+    void computeAdjointDirections(Workspace& workspace, const double* inputs, const double* seeds,
+                                  std::size_t numDirections, double* inputGradients,
+                                  double* outputs = nullptr) const;
+
+    void computeAdjoints(Workspace& workspace, const double* inputs, const double* seeds,
+                         double* inputGradients, double* outputs = nullptr) const {
+        computeAdjointDirections(workspace, inputs, seeds, 1, inputGradients, outputs);
+    }
+
+    std::size_t numInputs() const { return input_nodes_.size(); }
+    std::size_t numOutputs() const { return output_nodes_.size(); }
+    const HybridStats& stats() const { return stats_; }
+
+private:
+    struct Segment {
+        std::unique_ptr<ForwardReverseKernel> kernel;
+        std::vector<forge::NodeId> inputs;   // node IDs read from earlier stages
+        std::vector<forge::NodeId> outputs;  // node IDs read later
+        bool differentiable = false;         // any input needs an adjoint
+    };
+
+    struct HostCall {
+        HostFunction function;
+        std::vector<forge::NodeId> operands;
+        std::vector<bool> differentiable;    // per operand
+        forge::NodeId result;
+        bool needsGradient;
+    };
+
+    std::size_t num_nodes_ = 0;
+    std::vector<Segment> segments_;               // by stage, kernel is null if empty
+    std::vector<std::vector<HostCall>> host_calls_;  // by stage, calls of stage s run before segment s
+    std::vector<forge::NodeId> constant_nodes_;
+    std::vector<double> constant_values_;
+    std::vector<forge::NodeId> input_nodes_;
+    std::vector<bool> input_differentiable_;
+    std::vector<forge::NodeId> output_nodes_;
+    HybridStats stats_;
+};
+
+} // namespace forge_xad
@@ -2,14 +2,54 @@
 
 #include <XAD/XAD.hpp>
 #include "forge_xad/xad_tape_converter.hpp"
+#include "forge_xad/activity_analysis.hpp"
+#include "forge_xad/batch_kernel.hpp"
+#include "forge_xad/compilation_policy.hpp"
+#include "forge_xad/forward_reverse_kernel.hpp"
+#include "forge_xad/graph_interpreter.hpp"
+#include "forge_xad/graph_optimizer.hpp"
+#include "forge_xad/graph_transforms.hpp"
+#include "forge_xad/hessian_kernel.hpp"
+#include "forge_xad/host_functions.hpp"
+#include "forge_xad/hybrid_kernel.hpp"
+#include "forge_xad/kernel_cache.hpp"
+#include "forge_xad/partial_adjoints.hpp"
+#include "forge_xad/structural_hash.hpp"
+#include "forge_xad/tangent_kernel.hpp"
 #include <compiler/forge_engine.hpp>
 #include <compiler/compiler_config.hpp>
 #include <compiler/node_value_buffers/node_value_buffer.hpp>
-#include <memory>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <future>
 #include <iostream>
+#include <list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace forge_xad {
 
+/**
+ * @brief Number of adjoint directions of an XAD tape
+ *
+ * 1 for scalar tapes, N for vector-mode tapes (xad::Tape<double, N>), whose
+ * derivative() is an N-element array.
+ */
+template<class Tape>
+struct tape_dimension {
+    static constexpr std::size_t value = 1;
+};
+
+template<class Real, std::size_t N>
+struct tape_dimension<xad::Tape<Real, N>> {
+    static constexpr std::size_t value = N;
+};
+
 /**
  * @brief JIT-accelerated wrapper around XAD tape
  *
@@ -23,6 +63,75 @@ namespace forge_xad {
  *
  * The wrapper transparently delegates all operations to the underlying
  * tape but intercepts computeAdjoints() to use the compiled kernel.
+ *
+ * Replay mode (setReplayMode(true)):
+ *   Once a kernel exists, newRecording() deactivates the tape so that the
+ *   active-type arithmetic only computes values, and registerOutput()
+ *   just rebinds the output variable. Nothing is written to the tape
+ *   until the next iteration; computeAdjoints() runs the kernel on the
+ *   rebound variables. The recorded structure must not change between
+ *   iterations.
+ *
+ * Multi-version dispatch:
+ *   Outside replay mode every recording is fingerprinted (fingerprintTape())
+ *   before computeAdjoints() runs. Kernels are kept in a small LRU cache
+ *   keyed by that fingerprint, so a data-dependent branch that changes the
+ *   recorded path selects (or compiles) the matching kernel instead of
+ *   silently reusing the wrong one. A key hit is only used if the full
+ *   TapeFingerprint (second hash and counts) matches as well; otherwise
+ *   the old version is dropped and the recording compiled afresh.
+ *
+ * Single precision (JITTape<xad::Tape<float>>):
+ *   Forge kernels compute in double. Values are widened when scattered
+ *   into the kernel and values and derivatives are rounded to float when
+ *   gathered; only the recorded inputs and constants carry float error.
+ *
+ * Vector mode (JITTape<xad::Tape<double, N>>):
+ *   derivative() holds N adjoint directions. computeAdjoints() runs them
+ *   on the AVX2 batch kernel with one direction per lane, so N directions
+ *   cost ceil(N / BatchKernel::LANES) kernel executions (or N scalar
+ *   sweeps if a compilation policy picks SSE2). Partial sweeps
+ *   (computeAdjointsTo()) stay on the tape.
+ *
+ * Background compilation (setAsyncCompilation(true)):
+ *   A new recording shape is converted on the calling thread (the tape is
+ *   not thread-safe), then optimized and compiled on a separate thread.
+ *   Until the kernel is ready, computeAdjoints() runs the tape; the
+ *   finished version is published through an atomic pointer and picked up
+ *   at the next computeAdjoints() without blocking. Kernel-only entry
+ *   points (evaluate(), forward(), computeBatch(), bound arrays, ...) wait
+ *   for the pending compilation instead. Evicting or destroying a version
+ *   that is still compiling blocks until its compile thread finishes.
+ *
+ * Compilation policy (setCompilationPolicy()):
+ *   Without a policy every new shape is compiled at its first dispatch.
+ *   With one, a new shape starts interpreted and the policy is consulted
+ *   (see CompilationPolicy) before each computeAdjoints() until it decides
+ *   to compile, and at which instruction set: SSE2 scalar sweeps one
+ *   direction at a time, AVX2 packed runs the batch kernel with one
+ *   direction per lane. Kernel-only entry points compile regardless.
+ *
+ * Interpreter backend (setExecutionBackend(ExecutionBackend::Interpreter)):
+ *   Versions are lowered to GraphInterpreter bytecode instead of native
+ *   code: no code generation latency, slower sweeps. computeAdjoints()
+ *   (vector mode included: one forward pass, then one reverse sweep per
+ *   direction), evaluate() and bound arrays run on the interpreter; the
+ *   batch, tangent, Hessian and forward/reverse kernels are still compiled
+ *   on first request.
+ *
+ * Hybrid execution (setHostFunctions()):
+ *   Statements whose opcode Forge does not support (and the converter
+ *   cannot lower) become host calls, and the rest of the graph is
+ *   compiled in segments around them (see HybridKernel);
+ *   getHybridStats() reports the compiled share. builtinHostFunctions()
+ *   is used by default, so erf, atan2 and friends no longer force the
+ *   tape; without a matching host function the recording runs on the
+ *   tape.
+ *   computeAdjoints() (one forward pass, one reverse sweep per
+ *   direction), evaluate(), forward() and bound arrays run hybrid, on
+ *   either backend. Batch, Jacobian, tangent and Hessian kernels need the
+ *   whole graph and throw; partial sweeps stay on the tape. Hybrid
+ *   conversions are not stored in the kernel cache.
  */
 template<class BaseTape>
 class JITTape {
@@ -34,51 +143,651 @@ public:
     using position_type = typename BaseTape::position_type;
 
     static constexpr slot_type INVALID_SLOT = BaseTape::INVALID_SLOT;
+    static constexpr std::size_t DIMENSION = tape_dimension<BaseTape>::value;
+
+    /**
+     * @brief Counters for the fingerprint-keyed kernel cache
+     */
+    struct DispatchStats {
+        std::size_t hits = 0;        // recording matched a cached kernel
+        std::size_t misses = 0;      // recording needed a new kernel
+        std::size_t recompiles = 0;  // misses after the first compilation
+        std::size_t collisions = 0;  // key hits that were a different recording
+    };
+
+    /**
+     * @brief Compile latency and computeAdjoints() execution latency
+     *
+     * conversionMs is spent on the calling thread. compileMs covers the
+     * optimizer and code generation, which run on the compile thread with
+     * background compilation; it is added when the kernel is published.
+     */
+    struct LatencyStats {
+        std::size_t compilations = 0;
+        double conversionMs = 0.0;
+        double compileMs = 0.0;
+        std::size_t kernelRuns = 0;   // computeAdjoints() on a compiled kernel
+        double kernelMs = 0.0;
+        std::size_t tapeRuns = 0;     // computeAdjoints() on the tape
+        double tapeMs = 0.0;
+    };
 
-    JITTape() : tape_(), compiled_(false), kernel_(nullptr) {}
+    JITTape()
+        : tape_(), replay_enabled_(false), replaying_(false), current_(nullptr) {}
 
     // ===== Delegate to underlying tape =====
 
-    void registerInput(active_type& inp) {
-        tape_.registerInput(inp);
+    void registerInput(active_type& inp) { bindInput(inp, true); }
 
-        // Store reference to input variable for value synchronization
-        if (!compiled_) {
-            input_vars_.push_back(&inp);
-        }
-    }
+    /**
+     * @brief Register an input whose gradient is not needed
+     *
+     * The input is still bound for values, but the compiled kernel has no
+     * adjoint paths for it and computeAdjoints() leaves its derivative()
+     * untouched. Which inputs are value-only is part of the kernel
+     * fingerprint, so changing the selection compiles a separate kernel.
+     */
+    void registerValueInput(active_type& inp) { bindInput(inp, false); }
 
     void registerOutput(active_type& outp) {
-        tape_.registerOutput(outp);
-
-        // Store reference to output variable for gradient synchronization
-        if (!compiled_) {
-            output_vars_.push_back(&outp);
+        if (replaying_) {
+            // Values were computed without recording - make the tape
+            // active again (on the first output) so derivative() works on
+            // the bound variables. The iteration stays a replay until the
+            // next newRecording(), whatever the number of outputs.
+            if (!tape_.isActive()) {
+                tape_.activate();
+            }
+        } else {
+            tape_.registerOutput(outp);
+            needs_dispatch_ = true;
+            tape_recorded_ = true;
         }
 
-        // After first registerOutput, trigger compilation
-        if (!compiled_) {
-            tryCompile();
-        }
+        // Store reference to output variable for gradient synchronization
+        output_vars_.push_back(&outp);
+        new_iteration_ = true;
     }
 
     void newRecording() {
+        output_vars_.clear();
+        needs_dispatch_ = false;
+        forward_version_ = nullptr;
+        replaying_ = false;
+
+        if (replay_enabled_ && isCompiled()) {
+            // Replay: skip recording entirely, the kernel already holds
+            // the structure of this computation
+            if (tape_.isActive()) {
+                tape_.deactivate();
+                replaying_ = true;
+            }
+            tape_recorded_ = false;
+            return;
+        }
+
         tape_.newRecording();
     }
 
     void computeAdjoints() {
-        if (compiled_ && kernel_) {
-            // Use compiled kernel (SSE2 scalar mode for simplicity)
-            executeCompiledKernel();
+        // Pick (or compile) the kernel matching this recording
+        selectVersion();
+        if (current_ != nullptr) {
+            ++current_->evaluations;
+            if (current_->deferred) {
+                consultPolicy(*current_);
+            }
+            if (isCompiled() && current_->packed && !current_->interpreter && !current_->hybrid) {
+                getBatchKernel();  // compile outside the timed run
+            }
+        }
+        const auto start = Clock::now();
+
+        if constexpr (DIMENSION == 1) {
+            if (forward_version_ != nullptr && forward_version_ == current_) {
+                // Values are still in place from forward()
+                executeReverseKernel(*current_);
+                recordExecution(start, true);
+                return;
+            }
+        }
+
+        bool compiled = true;
+        if (arrays_bound_) {
+            waitForCompilation();
+            executeWithArrays(requireCompiled(), false);
+        } else if (isCompiled()) {
+            if (current_->interpreter) {
+                executeDirections(*current_->interpreter, current_->interpreter_workspace);
+            } else if (current_->hybrid) {
+                executeDirections(*current_->hybrid, current_->hybrid_workspace);
+            } else if (current_->packed) {
+                executeVectorKernel();
+            } else {
+                // SSE2 scalar kernel, one sweep per direction
+                executeCompiledKernel(*current_);
+            }
         } else {
-            // Fall back to tape-based adjoints
+            // Fall back to tape-based adjoints (also while compiling)
             tape_.computeAdjoints();
+            compiled = false;
+        }
+        recordExecution(start, compiled);
+    }
+
+    /**
+     * @brief Recompute output values without any adjoint work
+     *
+     * Runs a forward-only kernel, compiled on first use from the same
+     * converted graph, on the current values of the bound inputs and writes
+     * the results into the output variables. Gradients are neither cleared,
+     * seeded nor read, so this is the cheap path for price-only calls, e.g.
+     * changing input values and re-evaluating without re-running the
+     * recorded function. Falls back to leaving the recorded values in place
+     * if the tape could not be compiled.
+     */
+    void evaluate() {
+        waitForCompilation();
+        if (!arrays_bound_ && !isCompiled()) {
+            return;  // recorded values are already current
         }
+        CompiledVersion& version = requireCompiled();
+        if (version.interpreter) {
+            std::vector<double> inputs;
+            const double* input_values = currentInputValues(inputs);
+            std::vector<double> outputs(version.interpreter->numOutputs());
+            version.interpreter->evaluate(version.interpreter_workspace, input_values, outputs.data());
+            storeOutputValues(outputs);
+            return;
+        }
+        if (version.hybrid && !arrays_bound_) {
+            std::vector<double> inputs;
+            const double* input_values = currentInputValues(inputs);
+            std::vector<double> outputs(version.hybrid->numOutputs());
+            version.hybrid->evaluate(version.hybrid_workspace, input_values, outputs.data());
+            storeOutputValues(outputs);
+            return;
+        }
+        if (!version.primal_kernel && !version.hybrid) {
+            std::cout << "[JITTape] Compiling primal kernel (SSE2 scalar)...\n";
+            const forge::Graph primal = makePrimalGraph(version.conversion.graph);
+            forge::CompilerConfig config = forge::CompilerConfig::Default();
+            config.instructionSet = forge::CompilerConfig::InstructionSet::SSE2_SCALAR;
+            forge::ForgeEngine engine(config);
+            version.primal_kernel = engine.compile(primal);
+            version.primal_buffer = forge::NodeValueBufferFactory::create(primal, *version.primal_kernel);
+        }
+        if (arrays_bound_) {
+            executeWithArrays(version, true);
+        } else {
+            executePrimalKernel(version);
+        }
+    }
+
+    /**
+     * @brief Forward pass only, keeping the values for repeated reverse sweeps
+     *
+     * Runs the forward kernel of a ForwardReverseKernel (the segments of a
+     * hybrid version) on the current inputs and writes the outputs. Until the next iteration starts (or
+     * forward() is called again), computeAdjoints() then runs only the
+     * separately compiled reverse kernel on the stored values, so trying
+     * several output seeds costs one forward pass in total. Input values
+     * changed after forward() are not seen by those reverse sweeps.
+     *
+     * @throws std::runtime_error if the tape could not be compiled
+     */
+    void forward() {
+        static_assert(DIMENSION == 1, "forward() supports scalar tapes only");
+        waitForCompilation();
+        if (!isCompiled()) {
+            throw std::runtime_error("JITTape: no compiled kernel available for forward()");
+        }
+        CompiledVersion& version = *current_;
+        if (version.hybrid) {
+            // Segments are forward/reverse kernels already
+            std::vector<double> inputs;
+            const double* input_values = currentInputValues(inputs);
+            std::vector<double> outputs(version.hybrid->numOutputs());
+            version.hybrid->forward(version.hybrid_workspace, input_values, outputs.data());
+            storeOutputValues(outputs);
+            forward_version_ = &version;
+            return;
+        }
+        if (!version.forward_reverse) {
+            std::cout << "[JITTape] Compiling forward and reverse kernels (SSE2 scalar)...\n";
+            version.forward_reverse = std::make_unique<ForwardReverseKernel>(version.conversion);
+            version.forward_reverse_buffer = version.forward_reverse->createBuffer();
+        }
+
+        std::vector<double> inputs;
+        const double* input_values = currentInputValues(inputs);
+        std::vector<double> outputs(version.forward_reverse->numOutputs());
+        version.forward_reverse->forward(*version.forward_reverse_buffer, input_values, outputs.data());
+        storeOutputValues(outputs);
+        forward_version_ = &version;
+    }
+
+    /// Drop the values of forward(); computeAdjoints() runs the fused kernel again
+    void discardForward() { forward_version_ = nullptr; }
+
+    /**
+     * @brief Bind caller-owned arrays as the kernel's inputs and outputs
+     *
+     * Once bound, computeAdjoints() and evaluate() read input values from
+     * inputs[i] and write outputs[i] / inputGradients[i] directly, in
+     * registration order, instead of going through the registered AD
+     * variables. Those variables may then go out of scope; only the
+     * arrays must stay alive until unbindArrays(). A compiled kernel is
+     * required, so record (and compute) at least once before running with
+     * bound arrays.
+     *
+     * @param inputs         numInputs input values
+     * @param outputs        numOutputs output values (written)
+     * @param inputGradients numInputs gradients (written), or nullptr;
+     *                       value-only inputs read back as 0
+     * @param outputSeeds    numOutputs adjoint seeds, or nullptr for 1.0
+     */
+    void bindArrays(const double* inputs, double* outputs, double* inputGradients = nullptr,
+                    const double* outputSeeds = nullptr) {
+        arrays_.inputs = inputs;
+        arrays_.outputs = outputs;
+        arrays_.inputGradients = inputGradients;
+        arrays_.outputSeeds = outputSeeds;
+        arrays_bound_ = true;
+        forward_version_ = nullptr;
+    }
+
+    /// Go back to synchronising through the registered AD variables
+    void unbindArrays() {
+        arrays_ = ArrayBinding();
+        arrays_bound_ = false;
+        forward_version_ = nullptr;
     }
 
+    bool hasBoundArrays() const { return arrays_bound_; }
+
     void clearAll() {
         tape_.clearAll();
-        // Note: Keep compiled kernel - it's still valid for same structure
+        tape_recorded_ = false;
+        forward_version_ = nullptr;
+        // Note: Keep compiled kernels - the next recording is dispatched
+        // by its fingerprint
+        needs_dispatch_ = false;
+        new_iteration_ = true;
+    }
+
+    /**
+     * @brief Evaluate values and adjoints for many input sets at once
+     *
+     * Uses a second kernel compiled with AVX2 (BatchKernel::LANES scenarios
+     * per execution) from the same converted graph. Data is in
+     * structure-of-arrays form: scenario s of input i is inputs[i * numScenarios + s],
+     * with inputs and outputs in registration order. XAD variables are
+     * not touched.
+     *
+     * @param numScenarios Number of input sets (any value, tail is handled)
+     * @param inputs Input values, [numInputs][numScenarios]
+     * @param outputs Output values, [numOutputs][numScenarios] (may be nullptr)
+     * @param inputGradients Input adjoints, [numInputs][numScenarios] (may be nullptr)
+     * @param outputSeeds Adjoint seed per output (nullptr seeds all outputs with 1.0)
+     * @throws std::runtime_error if the tape could not be compiled
+     */
+    void computeBatch(std::size_t numScenarios, const double* inputs, double* outputs,
+                      double* inputGradients, const double* outputSeeds = nullptr) {
+        const BatchKernel& batch = getBatchKernel();
+        batch.execute(*current_->batch_buffer, numScenarios, inputs, outputs, inputGradients,
+                      outputSeeds);
+    }
+
+    /**
+     * @brief computeBatch() on single-precision scenario data
+     *
+     * Halves the size of the caller's scenario arrays; the kernel still
+     * evaluates in double (see BatchKernel::execute()).
+     */
+    void computeBatch(std::size_t numScenarios, const float* inputs, float* outputs,
+                      float* inputGradients, const double* outputSeeds = nullptr) {
+        const BatchKernel& batch = getBatchKernel();
+        batch.execute(*current_->batch_buffer, numScenarios, inputs, outputs, inputGradients,
+                      outputSeeds);
+    }
+
+    /**
+     * @brief Dense Jacobian of the registered outputs at the current inputs
+     *
+     * Uses the AVX2 batch kernel with one unit output seed per lane (see
+     * BatchKernel::computeJacobian()), so m outputs take ceil(m / LANES)
+     * kernel calls instead of m reverse sweeps. Inputs come from the bound
+     * arrays if any, otherwise from the registered variables; output
+     * values are written back the same way. Value-only inputs get zero
+     * columns.
+     *
+     * @return Row-major [numOutputs][numInputs] Jacobian
+     * @throws std::runtime_error if the tape could not be compiled
+     */
+    std::vector<double> computeJacobian() {
+        const BatchKernel& batch = getBatchKernel();
+        std::vector<double> inputs;
+        const double* input_values = currentInputValues(inputs);
+
+        std::vector<double> jacobian(batch.numOutputs() * batch.numInputs());
+        std::vector<double> outputs(batch.numOutputs());
+        batch.computeJacobian(*current_->batch_buffer, input_values, jacobian.data(), outputs.data());
+        storeOutputValues(outputs);
+        return jacobian;
+    }
+
+    /**
+     * @brief Sparse Jacobian using output colouring
+     *
+     * The output-input dependency pattern is derived from the compiled
+     * graph and outputs that share no input are coloured together (see
+     * colourJacobian()); this is done once per kernel version. Each colour
+     * then costs one reverse sweep, LANES colours per batch-kernel call,
+     * instead of one sweep per output. Inputs and output values are
+     * handled as in computeJacobian().
+     *
+     * @return Jacobian in CSR form
+     * @throws std::runtime_error if the tape could not be compiled
+     */
+    SparseJacobian computeSparseJacobian() {
+        const BatchKernel& batch = getBatchKernel();
+        if (!current_->colouring) {
+            current_->colouring = std::make_unique<JacobianColouring>(colourJacobian(current_->conversion));
+            std::cout << "[JITTape] Jacobian colouring: " << current_->colouring->numColours
+                      << " colours for " << current_->colouring->numOutputs << " outputs\n";
+        }
+        std::vector<double> inputs;
+        const double* input_values = currentInputValues(inputs);
+
+        SparseJacobian jacobian;
+        std::vector<double> outputs(batch.numOutputs());
+        batch.computeSparseJacobian(*current_->batch_buffer, input_values, *current_->colouring,
+                                    jacobian, outputs.data());
+        storeOutputValues(outputs);
+        return jacobian;
+    }
+
+    /// Colouring used by computeSparseJacobian(), nullptr before its first call
+    const JacobianColouring* getJacobianColouring() const {
+        return current_ ? current_->colouring.get() : nullptr;
+    }
+
+    /**
+     * @brief Forward-mode derivatives, mirroring xad::fwd usage
+     *
+     * Set derivative(x) on the registered inputs to the tangent direction
+     * and read derivative(y) on the outputs afterwards, as with FReal. The
+     * values come from a compiled tangent kernel (see TangentKernel); the
+     * recorded tape is only used to obtain the graph. Note that
+     * derivative() shares storage with the reverse-mode adjoints, so seed
+     * again before calling computeAdjoints().
+     *
+     * @throws std::runtime_error if the tape could not be compiled
+     */
+    void computeTangents() {
+        static_assert(DIMENSION == 1,
+                      "computeTangents() needs scalar derivatives; use the multi-direction overload");
+        const TangentKernel& kernel = getTangentKernel();
+        checkBindings(current_->conversion);
+
+        std::vector<double> inputs(input_vars_.size()), direction(input_vars_.size());
+        for (std::size_t i = 0; i < input_vars_.size(); ++i) {
+            inputs[i] = xad::value(*input_vars_[i]);
+            direction[i] = xad::derivative(*input_vars_[i]);
+        }
+        std::vector<double> outputs(output_vars_.size()), tangents(output_vars_.size());
+        kernel.execute(*current_->tangent_buffer, inputs.data(), direction.data(), 1,
+                       outputs.data(), tangents.data());
+        for (std::size_t j = 0; j < output_vars_.size(); ++j) {
+            xad::value(*output_vars_[j]) = outputs[j];
+            xad::derivative(*output_vars_[j]) = tangents[j];
+        }
+    }
+
+    /**
+     * @brief Propagate several tangent directions at once
+     *
+     * @param directions Input tangents, [numDirections][numInputs]
+     * @param numDirections Number of directions (LANES per kernel call)
+     * @param outputTangents Output tangents, [numDirections][numOutputs]
+     */
+    void computeTangents(const double* directions, std::size_t numDirections, double* outputTangents) {
+        const TangentKernel& kernel = getTangentKernel();
+        std::vector<double> inputs;
+        const double* input_values = currentInputValues(inputs);
+        std::vector<double> outputs(kernel.numOutputs());
+        kernel.execute(*current_->tangent_buffer, input_values, directions, numDirections,
+                       outputs.data(), outputTangents);
+        storeOutputValues(outputs);
+    }
+
+    /**
+     * @brief Tangent kernel for this tape, compiled on first request
+     *
+     * @throws std::runtime_error if the tape could not be compiled
+     */
+    const TangentKernel& getTangentKernel() {
+        waitForCompilation();
+        if (!isCompiled()) {
+            throw std::runtime_error("JITTape: no compiled kernel available for tangent mode");
+        }
+        if (current_->hybrid) {
+            throw std::runtime_error("JITTape: tangent mode needs a graph without host functions");
+        }
+        if (!current_->tangent_kernel) {
+            std::cout << "[JITTape] Compiling tangent kernel (AVX2, "
+                      << TangentKernel::LANES << " directions)...\n";
+            current_->tangent_kernel = std::make_unique<TangentKernel>(current_->conversion);
+            current_->tangent_buffer = current_->tangent_kernel->createBuffer();
+        }
+        return *current_->tangent_kernel;
+    }
+
+    /**
+     * @brief Dense Hessian at the current inputs
+     *
+     * Runs the compiled second-order kernel (see HessianKernel), LANES
+     * unit directions per call. The recorded tape is only used to obtain
+     * the graph, so new input values need no re-recording. Inputs and
+     * output values are handled as in computeJacobian().
+     *
+     * @param outputWeights Weight per output (nullptr: Hessian of the sum of outputs)
+     * @return Row-major [numInputs][numInputs] Hessian
+     * @throws std::runtime_error if the tape could not be compiled
+     */
+    std::vector<double> computeHessian(const double* outputWeights = nullptr) {
+        const HessianKernel& kernel = getHessianKernel();
+        std::vector<double> inputs;
+        const double* input_values = currentInputValues(inputs);
+
+        std::vector<double> hessian(kernel.numInputs() * kernel.numInputs());
+        std::vector<double> outputs(kernel.numOutputs());
+        kernel.computeHessian(*current_->hessian_buffer, input_values, outputWeights,
+                              hessian.data(), nullptr, outputs.data());
+        storeOutputValues(outputs);
+        return hessian;
+    }
+
+    /**
+     * @brief Hessian-vector product H v at the current inputs
+     *
+     * One kernel call, independent of the number of inputs.
+     *
+     * @param direction Tangent direction v, [numInputs]
+     * @param outputWeights Weight per output (nullptr: Hessian of the sum of outputs)
+     * @return H v, [numInputs]
+     * @throws std::runtime_error if the tape could not be compiled
+     */
+    std::vector<double> hessianVectorProduct(const double* direction,
+                                             const double* outputWeights = nullptr) {
+        const HessianKernel& kernel = getHessianKernel();
+        std::vector<double> inputs;
+        const double* input_values = currentInputValues(inputs);
+
+        std::vector<double> product(kernel.numInputs());
+        std::vector<double> outputs(kernel.numOutputs());
+        kernel.hessianVectorProducts(*current_->hessian_buffer, input_values, direction, 1,
+                                     outputWeights, product.data(), nullptr, outputs.data());
+        storeOutputValues(outputs);
+        return product;
+    }
+
+    /**
+     * @brief Second-order kernel for this tape, compiled on first request
+     *
+     * @throws std::runtime_error if the tape could not be compiled
+     */
+    const HessianKernel& getHessianKernel() {
+        waitForCompilation();
+        if (!isCompiled()) {
+            throw std::runtime_error("JITTape: no compiled kernel available for second-order mode");
+        }
+        if (current_->hybrid) {
+            throw std::runtime_error("JITTape: second-order mode needs a graph without host functions");
+        }
+        if (!current_->hessian_kernel) {
+            std::cout << "[JITTape] Compiling Hessian kernel (AVX2, "
+                      << HessianKernel::LANES << " directions)...\n";
+            current_->hessian_kernel = std::make_unique<HessianKernel>(current_->conversion);
+            current_->hessian_buffer = current_->hessian_kernel->createBuffer();
+        }
+        return *current_->hessian_kernel;
+    }
+
+    /**
+     * @brief AVX2 kernel for this tape, compiled on first request
+     *
+     * Belongs to the kernel version of the current recording and stays
+     * valid until that version is evicted (see setMaxKernelVersions()).
+     *
+     * @throws std::runtime_error if the tape could not be compiled
+     */
+    const BatchKernel& getBatchKernel() {
+        waitForCompilation();
+        if (!isCompiled()) {
+            throw std::runtime_error("JITTape: no compiled kernel available for batch execution");
+        }
+        if (current_->hybrid) {
+            throw std::runtime_error("JITTape: batch execution needs a graph without host functions");
+        }
+        if (!current_->batch_kernel) {
+            std::cout << "[JITTape] Compiling batch kernel (AVX2, "
+                      << BatchKernel::LANES << " lanes)...\n";
+            current_->batch_kernel = std::make_unique<BatchKernel>(current_->conversion);
+            current_->batch_buffer = current_->batch_kernel->createBuffer();
+        }
+        return *current_->batch_kernel;
+    }
+
+    /**
+     * @brief Use a persistent cache for converted tapes
+     *
+     * Must be set before the first compilation. The cache can be shared
+     * between tapes; pass nullptr to disable.
+     */
+    void setKernelCache(std::shared_ptr<KernelCache> cache) { kernel_cache_ = std::move(cache); }
+
+    /**
+     * @brief Skip tape recording for iterations after the first compilation
+     *
+     * Takes effect at the next newRecording() once a kernel exists.
+     */
+    void setReplayMode(bool enabled) { replay_enabled_ = enabled; }
+    bool isReplayMode() const { return replay_enabled_; }
+
+    /**
+     * @brief Select the graph passes run between conversion and compilation
+     *
+     * Applies to kernels compiled afterwards; all passes are on by default.
+     */
+    void setOptimizerOptions(const GraphOptimizerOptions& options) { optimizer_options_ = options; }
+    const GraphOptimizerOptions& getOptimizerOptions() const { return optimizer_options_; }
+
+    /**
+     * @brief Maximum number of kernels kept for different recording shapes
+     *
+     * The least recently used kernel is evicted when a new shape needs
+     * compiling and the limit is reached.
+     */
+    void setMaxKernelVersions(std::size_t count) { max_versions_ = count > 0 ? count : 1; }
+    std::size_t getNumKernelVersions() const { return versions_.size(); }
+
+    /**
+     * @brief Maximum number of computeAdjointsTo() positions kept compiled
+     *
+     * Per recording shape; the least recently swept position is evicted
+     * when a new one needs compiling and the limit is reached.
+     */
+    void setMaxPartialKernels(std::size_t count) { max_partial_kernels_ = count > 0 ? count : 1; }
+    const DispatchStats& getDispatchStats() const { return dispatch_stats_; }
+
+    /**
+     * @brief Compile new recording shapes on a background thread
+     *
+     * Off by default: the first computeAdjoints() of a shape then compiles
+     * and runs the kernel synchronously.
+     */
+    void setAsyncCompilation(bool enabled) { async_compilation_ = enabled; }
+    bool isAsyncCompilation() const { return async_compilation_; }
+
+    /// True while the current recording's kernel is still being compiled
+    bool isCompilationPending() const { return current_ != nullptr && current_->pending != nullptr; }
+
+    /**
+     * @brief Block until the current recording's kernel is compiled
+     *
+     * Returns immediately without background compilation. isCompiled()
+     * tells afterwards whether compilation succeeded.
+     */
+    void waitForCompilation() {
+        selectVersion();
+        if (current_ != nullptr && current_->deferred) {
+            promote(*current_, defaultInstructionSet());
+        }
+        if (isCompilationPending()) {
+            current_->pending->job.wait();
+            adoptCompiled(*current_);
+        }
+    }
+
+    const LatencyStats& getLatencyStats() const { return latency_stats_; }
+
+    /**
+     * @brief Run new versions as native code or on the graph interpreter
+     *
+     * Applies to versions compiled afterwards.
+     */
+    void setExecutionBackend(ExecutionBackend backend) { backend_ = backend; }
+    ExecutionBackend getExecutionBackend() const { return backend_; }
+
+    /**
+     * @brief Decide per recording shape whether and how to compile
+     *
+     * Applies to shapes dispatched afterwards; pass nullptr to compile
+     * every shape on first use again.
+     */
+    void setCompilationPolicy(std::shared_ptr<CompilationPolicy> policy) { policy_ = std::move(policy); }
+    const std::shared_ptr<CompilationPolicy>& getCompilationPolicy() const { return policy_; }
+
+    /// True if the current recording runs on the tape because the policy said so
+    bool isInterpreted() const { return current_ != nullptr && current_->deferred; }
+
+    /**
+     * @brief Evaluate opcodes Forge does not support on the host
+     *
+     * Defaults to builtinHostFunctions(). Applies to shapes compiled
+     * afterwards; a shape that already fell back to the tape is not
+     * retried. Pass nullptr to run such shapes on the tape again.
+     */
+    void setHostFunctions(std::shared_ptr<const HostFunctionRegistry> functions) {
+        host_functions_ = std::move(functions);
+    }
+    const std::shared_ptr<const HostFunctionRegistry>& getHostFunctions() const { return host_functions_; }
+
+    /// Compiled share of the current recording, nullptr unless it runs hybrid
+    const HybridStats* getHybridStats() const {
+        return current_ != nullptr && current_->hybrid ? &current_->hybrid->stats() : nullptr;
     }
 
     // Accessor methods
@@ -93,111 +802,921 @@ public:
 
     position_type getPosition() const { return tape_.getPosition(); }
     void clearDerivativesAfter(position_type pos) { tape_.clearDerivativesAfter(pos); }
-    void resetTo(position_type pos) { tape_.resetTo(pos); }
+
+    /**
+     * @brief Truncate the recording to a position, as the tape does
+     *
+     * The truncated tape is a different recording shape: the next
+     * computeAdjoints(), computeAdjointsTo() or forward() dispatches it
+     * like a new recording, and the first time that shape is seen it is
+     * converted and compiled and takes a slot of setMaxKernelVersions().
+     * Re-recording the same statements afterwards matches the kernel of
+     * the full recording again. Checkpointing loops that sweep a truncated
+     * tape once per checkpoint should therefore sweep the full recording
+     * with computeAdjointsTo() and truncate after the last sweep, or raise
+     * setMaxKernelVersions() above the number of checkpoint shapes.
+     */
+    void resetTo(position_type pos) {
+        tape_.resetTo(pos);
+        needs_dispatch_ = tape_recorded_;  // the recording changed shape
+        forward_version_ = nullptr;
+    }
+    /**
+     * @brief Sweep adjoints back to a tape position on compiled code
+     *
+     * Same contract as the tape's computeAdjointsTo(): adjoints of every
+     * variable are the seeds, statements after pos are swept and the
+     * adjoints of variables live at pos stay readable via derivative().
+     * Each position gets its own kernel (see PartialAdjoints), compiled on
+     * first use and kept up to setMaxPartialKernels() per recording shape. Falls back to the tape without a kernel, when the
+     * iteration was replayed (there is no recording to sweep) and for
+     * vector-mode tapes.
+     */
     void computeAdjointsTo(position_type pos) {
-        if (compiled_ && kernel_) {
-            // TODO: Implement partial adjoints with kernel
+        if constexpr (DIMENSION > 1) {
             tape_.computeAdjointsTo(pos);
         } else {
-            tape_.computeAdjointsTo(pos);
+            sweepPartialAdjoints(pos);
         }
     }
 
     // Active tape management
-    static void activate() { BaseTape::activate(); }
-    static void deactivate() { BaseTape::deactivate(); }
+    void activate() { tape_.activate(); }
+    void deactivate() { tape_.deactivate(); }
+    bool isActive() const { return tape_.isActive(); }
     static void deactivateAll() { BaseTape::deactivateAll(); }
 
     // Get underlying tape for advanced use
     BaseTape& getTape() { return tape_; }
     const BaseTape& getTape() const { return tape_; }
 
-    // Check if compiled
-    bool isCompiled() const { return compiled_; }
+    // Check if a kernel is selected for the current recording
+    bool isCompiled() const {
+        return current_ != nullptr && (current_->kernel != nullptr || current_->interpreter != nullptr ||
+                                       current_->hybrid != nullptr);
+    }
 
 private:
+    using Clock = std::chrono::steady_clock;
+
+    void sweepPartialAdjoints(position_type pos) {
+        selectVersion();
+        if (!isCompiled() || !tape_recorded_ || current_->hybrid) {
+            tape_.computeAdjointsTo(pos);
+            return;
+        }
+        CompiledVersion& version = *current_;
+        checkBindings(version.conversion);
+
+        if (!version.partial) {
+            // Partial sweeps need the unoptimized graph: the optimizer may
+            // merge nodes across position boundaries, and seeds may sit on
+            // variables that no output depends on
+            ConversionOptions options;
+            options.differentiableInputs = input_differentiable_;
+            options.keepSlotNodes = true;
+            std::vector<std::uint32_t> statement_slots;
+            statement_slots.reserve(tape_.getStatements().size());
+            for (const auto& statement : tape_.getStatements()) {
+                statement_slots.push_back(static_cast<std::uint32_t>(statement.second));
+            }
+            const auto& input_slots = tape_.getInputSlots();
+            version.partial = std::make_unique<PartialAdjoints>(
+                convertXadTapeToForge(tape_, options),
+                std::vector<std::uint32_t>(input_slots.begin(), input_slots.end()),
+                std::move(statement_slots));
+        }
+        if (version.partial->getMaxPositionKernels() != max_partial_kernels_) {
+            version.partial->setMaxPositionKernels(max_partial_kernels_);
+        }
+
+        std::vector<double>& inputs = partial_inputs_;
+        inputs.resize(input_vars_.size());
+        for (std::size_t i = 0; i < input_vars_.size(); ++i) {
+            inputs[i] = xad::value(*input_vars_[i]);
+        }
+
+        // Only the slots the sweep reads or writes go back and forth
+        const auto& slots = version.partial->touchedSlots(static_cast<std::size_t>(pos));
+        std::vector<double>& adjoints = partial_slot_adjoints_;
+        adjoints.resize(version.partial->numSlots());
+        for (auto slot : slots) {
+            adjoints[slot] = tape_.derivative(static_cast<slot_type>(slot));
+        }
+
+        version.partial->computeAdjointsTo(static_cast<std::size_t>(pos), inputs.data(), adjoints);
+
+        for (auto slot : slots) {
+            tape_.derivative(static_cast<slot_type>(slot)) = adjoints[slot];
+        }
+    }
+
+    struct CompiledVersion;
+
+    /**
+     * @brief Compilation running on a background thread
+     *
+     * The compile thread fills its own CompiledVersion and publishes it
+     * with an atomic store; the calling thread polls with an atomic load
+     * and moves the result into the dispatched version. job is declared
+     * last so that it is destroyed (and joined) first.
+     */
+    struct PendingCompile {
+        std::shared_ptr<CompiledVersion> result;
+        std::future<void> job;
+    };
+
+    /**
+     * @brief Everything compiled for one recording shape
+     *
+     * kernel is null if compilation failed, while pending is set, or while
+     * the compilation policy keeps the shape deferred (interpreted). A
+     * failed shape stays on the tape-based path without retrying every
+     * iteration.
+     */
+    struct CompiledVersion {
+        ConversionResult conversion;
+        std::unique_ptr<forge::StitchedKernel> kernel;
+        std::unique_ptr<forge::INodeValueBuffer> buffer;
+        std::unique_ptr<GraphInterpreter> interpreter;  // instead of kernel and buffer
+        GraphInterpreter::Workspace interpreter_workspace;
+        std::unique_ptr<HybridKernel> hybrid;            // instead of kernel and buffer
+        HybridKernel::Workspace hybrid_workspace;
+        std::unique_ptr<BatchKernel> batch_kernel;
+        std::unique_ptr<forge::INodeValueBuffer> batch_buffer;
+        std::unique_ptr<forge::StitchedKernel> primal_kernel;
+        std::unique_ptr<forge::INodeValueBuffer> primal_buffer;
+        std::unique_ptr<PartialAdjoints> partial;
+        std::unique_ptr<JacobianColouring> colouring;
+        std::unique_ptr<TangentKernel> tangent_kernel;
+        std::unique_ptr<forge::INodeValueBuffer> tangent_buffer;
+        std::unique_ptr<HessianKernel> hessian_kernel;
+        std::unique_ptr<forge::INodeValueBuffer> hessian_buffer;
+        std::unique_ptr<ForwardReverseKernel> forward_reverse;
+        std::unique_ptr<forge::INodeValueBuffer> forward_reverse_buffer;
+        bool contiguous_inputs = false;   // input_nodes[i] == input_nodes[0] + i
+        bool contiguous_outputs = false;
+        double conversion_ms = 0.0;
+        double compile_ms = 0.0;
+        std::unique_ptr<PendingCompile> pending;
+        bool deferred = false;            // not compiled yet, the policy decides
+        bool packed = false;              // computeAdjoints() runs the AVX2 batch kernel
+        std::size_t num_statements = 0;
+        TapeFingerprint fingerprint;      // of the recording this was compiled from
+        std::size_t evaluations = 0;      // computeAdjoints() calls
+        std::size_t tape_runs = 0;
+        double tape_ms = 0.0;
+        typename std::list<std::uint64_t>::iterator lru_position;
+    };
+
     BaseTape tape_;
-    bool compiled_;
-    std::unique_ptr<forge::StitchedKernel> kernel_;
-    std::unique_ptr<forge::INodeValueBuffer> buffer_;
-    ConversionResult conversion_result_;
+    bool replay_enabled_;
+    bool replaying_;
+    bool needs_dispatch_ = false;
+    bool tape_recorded_ = false;  // the tape holds this iteration's recording
+    bool new_iteration_ = true;
+
+    // Kernels by tape fingerprint, most recently used at the front of lru_
+    std::unordered_map<std::uint64_t, std::unique_ptr<CompiledVersion>> versions_;
+    std::list<std::uint64_t> lru_;
+    std::size_t max_versions_ = 4;
+    std::size_t max_partial_kernels_ = 8;
+    CompiledVersion* current_;
+    CompiledVersion* forward_version_ = nullptr;  // holds the values of the last forward()
+    DispatchStats dispatch_stats_;
+
+    std::shared_ptr<KernelCache> kernel_cache_;
+    GraphOptimizerOptions optimizer_options_;
+    bool async_compilation_ = false;
+    LatencyStats latency_stats_;
+    std::shared_ptr<CompilationPolicy> policy_;
+    ExecutionBackend backend_ = ExecutionBackend::Compiled;
+    std::shared_ptr<const HostFunctionRegistry> host_functions_ = builtinHostFunctions();
+
+    struct ArrayBinding {
+        const double* inputs = nullptr;
+        double* outputs = nullptr;
+        double* inputGradients = nullptr;
+        const double* outputSeeds = nullptr;
+    };
+    ArrayBinding arrays_;
+    bool arrays_bound_ = false;
+
+    // Scratch for sweepPartialAdjoints()
+    std::vector<double> partial_inputs_;
+    std::vector<double> partial_slot_adjoints_;
 
-    // Store references to input/output variables for value synchronization
+    // Variables of the current iteration, in registration order
     std::vector<active_type*> input_vars_;
+    std::vector<bool> input_differentiable_;
     std::vector<active_type*> output_vars_;
 
-    void tryCompile() {
+    void bindInput(active_type& inp, bool differentiable) {
+        // A replayed iteration never reads the tape, so a variable that
+        // still holds a slot on it keeps that slot - otherwise input slots
+        // pile up when the same variables are registered every iteration.
+        // Variables without a live slot (new, or after clearAll()) still
+        // need one for derivative().
+        const bool live_slot = inp.shouldRecord() && inp.getSlot() < tape_.getNumVariables();
+        if (!(replay_enabled_ && isCompiled() && live_slot)) {
+            tape_.registerInput(inp);
+        }
+
+        // Store reference to input variable for value synchronization
+        if (new_iteration_) {
+            input_vars_.clear();
+            input_differentiable_.clear();
+            new_iteration_ = false;
+            forward_version_ = nullptr;
+        }
+        input_vars_.push_back(&inp);
+        input_differentiable_.push_back(differentiable);
+    }
+
+    /// Tape structure plus the value-only input selection
+    TapeFingerprint recordingFingerprint() const {
+        TapeFingerprint fingerprint = fingerprintTape(tape_);
+        for (bool differentiable : input_differentiable_) {
+            fingerprint.addWord(differentiable ? 1 : 0);
+        }
+        return fingerprint;
+    }
+
+    void dropVersion(std::uint64_t key) {
+        auto it = versions_.find(key);
+        if (forward_version_ == it->second.get()) {
+            forward_version_ = nullptr;
+        }
+        lru_.erase(it->second->lru_position);
+        versions_.erase(it);
+    }
+
+    /**
+     * @brief Select the kernel for the recording that was just made
+     *
+     * Then takes over a background compilation of the selected version if
+     * it has finished, without waiting for it.
+     */
+    void selectVersion() {
+        dispatchRecording();
+        if (isCompilationPending()) {
+            adoptCompiled(*current_);
+        }
+    }
+
+    /**
+     * @brief Look up (or start compiling) the version for the new recording
+     *
+     * No-op unless a new recording has been completed since the last
+     * dispatch (in replay mode nothing is recorded, so the current kernel
+     * stays selected).
+     */
+    void dispatchRecording() {
+        if (!needs_dispatch_) {
+            return;
+        }
+        needs_dispatch_ = false;
+
+        const TapeFingerprint fingerprint = recordingFingerprint();
+        const std::uint64_t key = fingerprint.key();
+        auto it = versions_.find(key);
+        if (it != versions_.end()) {
+            if (it->second->fingerprint == fingerprint) {
+                ++dispatch_stats_.hits;
+                current_ = it->second.get();
+                lru_.splice(lru_.begin(), lru_, current_->lru_position);
+                return;
+            }
+            // Same key, different recording: never run the other shape's kernel
+            std::cout << "[JITTape] Fingerprint collision, replacing cached version\n";
+            ++dispatch_stats_.collisions;
+            dropVersion(key);
+        }
+
+        ++dispatch_stats_.misses;
+        if (dispatch_stats_.misses > 1) {
+            ++dispatch_stats_.recompiles;
+        }
+
+        // Make room for the new shape
+        if (versions_.size() >= max_versions_) {
+            dropVersion(lru_.back());
+        }
+
+        auto version = std::make_unique<CompiledVersion>();
+        version->deferred = true;
+        version->num_statements = static_cast<std::size_t>(tape_.getNumStatements());
+        version->fingerprint = fingerprint;
+        lru_.push_front(key);
+        version->lru_position = lru_.begin();
+        current_ = version.get();
+        versions_[key] = std::move(version);
+
+        if (!policy_) {
+            promote(*current_, defaultInstructionSet());
+        }
+    }
+
+    using InstructionSet = forge::CompilerConfig::InstructionSet;
+
+    /// Vector-mode tapes run packed unless a policy says otherwise
+    static InstructionSet defaultInstructionSet() {
+        return DIMENSION > 1 ? InstructionSet::AVX2_PACKED : InstructionSet::SSE2_SCALAR;
+    }
+
+    static InstructionSet instructionSetOf(const CompiledVersion& version) {
+        return version.packed ? InstructionSet::AVX2_PACKED : InstructionSet::SSE2_SCALAR;
+    }
+
+    TapeProfile profileOf(const CompiledVersion& version) const {
+        TapeProfile profile;
+        profile.numStatements = version.num_statements;
+        profile.directions = DIMENSION;
+        profile.evaluations = version.evaluations;
+        profile.tapeMs = version.tape_runs > 0 ? version.tape_ms / static_cast<double>(version.tape_runs) : 0.0;
+        return profile;
+    }
+
+    void consultPolicy(CompiledVersion& version) {
+        const CompilationDecision decision = policy_->decide(profileOf(version));
+        if (decision.compile) {
+            std::cout << "[JITTape] Policy: compiling after " << version.evaluations
+                      << " evaluation(s) of " << version.num_statements << " statements\n";
+            promote(version, decision.instructionSet);
+        }
+    }
+
+    /**
+     * @brief Compile a deferred version from the tape's current recording
+     *
+     * Keeps the version's place in the LRU list and its counters.
+     */
+    void promote(CompiledVersion& version, InstructionSet instructionSet) {
+        if (!tape_recorded_) {
+            return;  // nothing to convert; stays deferred
+        }
+        auto compiled = tryCompile(version.fingerprint);
+        compiled->lru_position = version.lru_position;
+        compiled->packed = instructionSet == InstructionSet::AVX2_PACKED;
+        compiled->num_statements = version.num_statements;
+        compiled->fingerprint = version.fingerprint;
+        compiled->evaluations = version.evaluations;
+        compiled->tape_runs = version.tape_runs;
+        compiled->tape_ms = version.tape_ms;
+        version = std::move(*compiled);
+        if (!version.pending) {
+            notifyCompiled(version);
+        }
+    }
+
+    void notifyCompiled(const CompiledVersion& version) {
+        if (policy_ && (version.kernel || version.interpreter || version.hybrid)) {
+            policy_->observeCompilation(profileOf(version), instructionSetOf(version),
+                                        version.conversion_ms + version.compile_ms);
+        }
+    }
+
+    /// Sanity check of a cached conversion against the recorded tape
+    bool matchesTape(const ConversionResult& conversion) const {
+        return conversion.input_nodes.size() == tape_.getInputSlots().size() &&
+               conversion.output_nodes.size() == tape_.getOutputSlots().size() &&
+               conversion.slot_to_node.size() >= static_cast<std::size_t>(tape_.getNumVariables());
+    }
+
+    /**
+     * @brief Convert the recording, then compile it here or in the background
+     *
+     * Conversion reads the tape and the kernel cache, so it always runs on
+     * the calling thread.
+     */
+    std::unique_ptr<CompiledVersion> tryCompile(const TapeFingerprint& fingerprint) {
+        auto version = std::make_unique<CompiledVersion>();
+        const auto start = Clock::now();
         try {
-            std::cout << "[JITTape] Converting tape to Forge graph...\n";
+            // Reuse a previous process's conversion if the cache has one
+            bool cached = kernel_cache_ && kernel_cache_->load(fingerprint, version->conversion);
+            if (cached && !matchesTape(version->conversion)) {
+                std::cout << "[JITTape] Cached graph does not match the tape\n";
+                cached = false;
+            }
 
-            // Convert XAD tape to Forge graph
-            conversion_result_ = convertXadTapeToForge(tape_);
+            if (cached) {
+                std::cout << "[JITTape] Loaded converted graph from kernel cache\n";
+            } else {
+                std::cout << "[JITTape] Converting tape to Forge graph...\n";
 
+                // Convert XAD tape to Forge graph
+                ConversionOptions options;
+                options.differentiableInputs = input_differentiable_;
+                options.hostFunctions = host_functions_.get();
+                version->conversion = convertXadTapeToForge(tape_, options);
+
+                // Host nodes refer to this process's registry
+                if (kernel_cache_ && version->conversion.host_nodes.empty()) {
+                    kernel_cache_->store(fingerprint, version->conversion);
+                }
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "[JITTape] Compilation failed: " << e.what() << "\n";
+            std::cerr << "[JITTape] Falling back to tape-based computation\n";
+            return version;
+        }
+        version->conversion_ms = millisecondsSince(start);
+        ++latency_stats_.compilations;
+        latency_stats_.conversionMs += version->conversion_ms;
+
+        if (!async_compilation_) {
+            compileVersion(*version, optimizer_options_, backend_, host_functions_.get());
+            latency_stats_.compileMs += version->compile_ms;
+            return version;
+        }
+
+        std::cout << "[JITTape] Compiling in the background, tape serves until then\n";
+        auto staged = std::make_shared<CompiledVersion>();
+        staged->conversion = std::move(version->conversion);
+        version->pending = std::make_unique<PendingCompile>();
+        PendingCompile* pending = version->pending.get();
+        pending->job = std::async(std::launch::async, [pending, staged, options = optimizer_options_,
+                                                       backend = backend_, functions = host_functions_]() {
+            compileVersion(*staged, options, backend, functions.get());
+            std::atomic_store(&pending->result, staged);
+        });
+        return version;
+    }
+
+    /**
+     * @brief Optimize and compile (or lower to bytecode) a converted graph
+     *
+     * Touches nothing but version, so it can run on the compile thread.
+     * Graphs with host nodes are compiled as a HybridKernel on either
+     * backend.
+     */
+    static void compileVersion(CompiledVersion& version, const GraphOptimizerOptions& optimizerOptions,
+                               ExecutionBackend backend, const HostFunctionRegistry* hostFunctions) {
+        const auto start = Clock::now();
+        try {
+            const auto instruction_set = forge::CompilerConfig::InstructionSet::SSE2_SCALAR;
+
+            // The cache holds the unoptimized conversion, so passes can change
+            // without invalidating it
+            const GraphOptimizerStats optimized = optimizeGraph(version.conversion, optimizerOptions);
+            const ActivityStats activity = analyzeActivity(version.conversion.graph);
+            std::cout << "[JITTape] Optimizer: "
+                      << optimized.constantsFolded << " folded, "
+                      << optimized.subexpressionsEliminated << " CSE, "
+                      << optimized.simplified << " simplified, "
+                      << optimized.canonicalized << " canonicalized, "
+                      << activity.deadNodes << " unreachable\n";
+
+            const ConversionResult& conversion = version.conversion;
+            version.contiguous_inputs = isContiguous(conversion.input_nodes);
+            version.contiguous_outputs = isContiguous(conversion.output_nodes);
             std::cout << "[JITTape] Graph: "
-                      << conversion_result_.graph.nodes.size() << " nodes, "
-                      << conversion_result_.input_nodes.size() << " inputs, "
-                      << conversion_result_.output_nodes.size() << " outputs\n";
+                      << conversion.graph.nodes.size() << " nodes, "
+                      << conversion.input_nodes.size() << " inputs, "
+                      << conversion.output_nodes.size() << " outputs\n";
+
+            if (!conversion.host_nodes.empty()) {
+                if (hostFunctions == nullptr) {
+                    throw std::runtime_error("graph has host nodes but no host functions are set");
+                }
+                version.hybrid = std::make_unique<HybridKernel>(conversion, *hostFunctions);
+                version.hybrid_workspace = version.hybrid->createWorkspace();
+                const HybridStats& stats = version.hybrid->stats();
+                std::cout << "[JITTape] Hybrid: " << stats.compiledNodes << " of "
+                          << stats.compiledNodes + stats.hostNodes << " nodes compiled ("
+                          << 100.0 * stats.compiledShare() << "%) in " << stats.segments
+                          << " segment(s), " << stats.hostNodes << " host call(s)\n";
+                version.compile_ms = millisecondsSince(start);
+                return;
+            }
+
+            if (backend == ExecutionBackend::Interpreter) {
+                version.interpreter = std::make_unique<GraphInterpreter>(conversion);
+                version.interpreter_workspace = version.interpreter->createWorkspace();
+                std::cout << "[JITTape] Interpreter bytecode: "
+                          << version.interpreter->numForwardInstructions() << " forward, "
+                          << version.interpreter->numReverseInstructions() << " reverse instructions\n";
+                version.compile_ms = millisecondsSince(start);
+                return;
+            }
 
             // Compile the graph using ForgeEngine with SSE2 scalar mode (no SIMD)
             std::cout << "[JITTape] Compiling to native code (SSE2 scalar)...\n";
             forge::CompilerConfig config = forge::CompilerConfig::Default();
-            config.instructionSet = forge::CompilerConfig::InstructionSet::SSE2_SCALAR;
+            config.instructionSet = instruction_set;
             forge::ForgeEngine engine(config);
-            kernel_ = engine.compile(conversion_result_.graph);
+            version.kernel = engine.compile(conversion.graph);
 
             // Create buffer for value storage
-            buffer_ = forge::NodeValueBufferFactory::create(conversion_result_.graph, *kernel_);
+            version.buffer = forge::NodeValueBufferFactory::create(conversion.graph, *version.kernel);
 
-            compiled_ = true;
             std::cout << "[JITTape] Compilation successful!\n";
-            std::cout << "[JITTape] Buffer created: " << buffer_->getNumNodes() << " nodes\n";
+            std::cout << "[JITTape] Buffer created: " << version.buffer->getNumNodes() << " nodes\n";
 
         } catch (const std::exception& e) {
             std::cerr << "[JITTape] Compilation failed: " << e.what() << "\n";
             std::cerr << "[JITTape] Falling back to tape-based computation\n";
-            compiled_ = false;
+            version.kernel.reset();
+            version.buffer.reset();
+            version.interpreter.reset();
+            version.hybrid.reset();
         }
+        version.compile_ms = millisecondsSince(start);
     }
 
-    void executeCompiledKernel() {
-        // Step 1: Scatter - sync input values from XAD variables to Forge buffer
+    /**
+     * @brief Take over a background compilation if it has been published
+     *
+     * Never blocks on an unfinished compilation: the atomic load returns
+     * null until the compile thread is done with the result.
+     */
+    void adoptCompiled(CompiledVersion& version) {
+        std::shared_ptr<CompiledVersion> ready = std::atomic_load(&version.pending->result);
+        if (!ready) {
+            return;
+        }
+        version.pending->job.get();  // already finished, only joins
+        version.conversion = std::move(ready->conversion);
+        version.kernel = std::move(ready->kernel);
+        version.buffer = std::move(ready->buffer);
+        version.interpreter = std::move(ready->interpreter);
+        version.interpreter_workspace = std::move(ready->interpreter_workspace);
+        version.hybrid = std::move(ready->hybrid);
+        version.hybrid_workspace = std::move(ready->hybrid_workspace);
+        version.contiguous_inputs = ready->contiguous_inputs;
+        version.contiguous_outputs = ready->contiguous_outputs;
+        version.compile_ms = ready->compile_ms;
+        version.pending.reset();
+        latency_stats_.compileMs += version.compile_ms;
+        if (version.kernel || version.interpreter || version.hybrid) {
+            std::cout << "[JITTape] Background kernel published after "
+                      << version.compile_ms << " ms\n";
+        }
+        notifyCompiled(version);
+    }
+
+    static double millisecondsSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    void recordExecution(Clock::time_point start, bool compiled) {
+        const double ms = millisecondsSince(start);
+        if (compiled) {
+            ++latency_stats_.kernelRuns;
+            latency_stats_.kernelMs += ms;
+        } else {
+            ++latency_stats_.tapeRuns;
+            latency_stats_.tapeMs += ms;
+        }
+        if (current_ == nullptr) {
+            return;
+        }
+        if (!compiled) {
+            ++current_->tape_runs;
+            current_->tape_ms += ms;
+        }
+        if (policy_) {
+            if (compiled) {
+                policy_->observeKernelRun(profileOf(*current_), instructionSetOf(*current_), ms);
+            } else {
+                policy_->observeTapeRun(profileOf(*current_), ms);
+            }
+        }
+    }
+
+    static bool isContiguous(const std::vector<forge::NodeId>& nodes) {
+        for (std::size_t i = 1; i < nodes.size(); ++i) {
+            if (nodes[i] != nodes[0] + i) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Input values from the bound arrays or the registered variables
+    const double* currentInputValues(std::vector<double>& storage) const {
+        if (arrays_bound_) {
+            return arrays_.inputs;
+        }
+        checkBindings(current_->conversion);
+        storage.resize(input_vars_.size());
+        for (std::size_t i = 0; i < input_vars_.size(); ++i) {
+            storage[i] = xad::value(*input_vars_[i]);
+        }
+        return storage.data();
+    }
+
+    void storeOutputValues(const std::vector<double>& outputs) {
+        for (std::size_t j = 0; j < outputs.size(); ++j) {
+            if (arrays_bound_) {
+                arrays_.outputs[j] = outputs[j];
+            } else {
+                xad::value(*output_vars_[j]) = outputs[j];
+            }
+        }
+    }
+
+    CompiledVersion& requireCompiled() {
+        if (!isCompiled()) {
+            throw std::runtime_error("JITTape: bound arrays need a compiled kernel");
+        }
+        return *current_;
+    }
+
+    /**
+     * @brief Run a kernel straight from the bound arrays
+     *
+     * No per-variable virtual calls: values and gradients are moved with
+     * memcpy when the nodes are contiguous (inputs always are, since the
+     * converter creates them first) and with a plain indexed loop otherwise.
+     */
+    void executeWithArrays(CompiledVersion& version, bool primal) {
+        if (version.interpreter) {
+            // evaluate() returns early for the interpreter, so this is a sweep
+            version.interpreter->computeAdjoints(version.interpreter_workspace, arrays_.inputs,
+                                                 arrays_.outputSeeds, arrays_.inputGradients,
+                                                 arrays_.outputs);
+            return;
+        }
+        if (version.hybrid) {
+            if (primal) {
+                version.hybrid->evaluate(version.hybrid_workspace, arrays_.inputs, arrays_.outputs);
+            } else {
+                version.hybrid->computeAdjoints(version.hybrid_workspace, arrays_.inputs,
+                                                arrays_.outputSeeds, arrays_.inputGradients,
+                                                arrays_.outputs);
+            }
+            return;
+        }
+        const ConversionResult& conversion = version.conversion;
+        forge::INodeValueBuffer& buffer = primal ? *version.primal_buffer : *version.buffer;
+        forge::StitchedKernel& kernel = primal ? *version.primal_kernel : *version.kernel;
+        const std::size_t num_inputs = conversion.input_nodes.size();
+        const std::size_t num_outputs = conversion.output_nodes.size();
+
+        double* values = buffer.getValuesPtr();
+        if (version.contiguous_inputs && num_inputs > 0) {
+            std::memcpy(values + conversion.input_nodes[0], arrays_.inputs, num_inputs * sizeof(double));
+        } else {
+            for (std::size_t i = 0; i < num_inputs; ++i) {
+                values[conversion.input_nodes[i]] = arrays_.inputs[i];
+            }
+        }
+
+        // No gradient buffer if every input is value-only
+        double* gradients = buffer.getGradientsPtr();
+        if (!primal && gradients) {
+            buffer.clearGradients();
+            for (std::size_t i = 0; i < num_outputs; ++i) {
+                gradients[conversion.output_nodes[i]] += arrays_.outputSeeds ? arrays_.outputSeeds[i] : 1.0;
+            }
+        }
+
+        kernel.executeDirect(values, gradients, buffer.getNumNodes());
+
+        if (!primal && arrays_.inputGradients) {
+            if (!gradients) {
+                std::fill(arrays_.inputGradients, arrays_.inputGradients + num_inputs, 0.0);
+            } else if (version.contiguous_inputs && num_inputs > 0) {
+                std::memcpy(arrays_.inputGradients, gradients + conversion.input_nodes[0],
+                            num_inputs * sizeof(double));
+            } else {
+                for (std::size_t i = 0; i < num_inputs; ++i) {
+                    arrays_.inputGradients[i] = gradients[conversion.input_nodes[i]];
+                }
+            }
+        }
+
+        if (version.contiguous_outputs && num_outputs > 0) {
+            std::memcpy(arrays_.outputs, values + conversion.output_nodes[0], num_outputs * sizeof(double));
+        } else {
+            for (std::size_t i = 0; i < num_outputs; ++i) {
+                arrays_.outputs[i] = values[conversion.output_nodes[i]];
+            }
+        }
+    }
+
+    // A replayed iteration must register the same variables it was
+    // recorded with (recordings are matched by fingerprint instead)
+    void checkBindings(const ConversionResult& conversion) const {
+        if (input_vars_.size() != conversion.input_nodes.size() ||
+            output_vars_.size() != conversion.output_nodes.size()) {
+            throw std::runtime_error(
+                "JITTape: iteration registered " + std::to_string(input_vars_.size()) +
+                " inputs / " + std::to_string(output_vars_.size()) +
+                " outputs, compiled kernel expects " +
+                std::to_string(conversion.input_nodes.size()) + " / " +
+                std::to_string(conversion.output_nodes.size()));
+        }
+    }
+
+    void executePrimalKernel(CompiledVersion& version) {
+        const ConversionResult& conversion = version.conversion;
+        forge::INodeValueBuffer& buffer = *version.primal_buffer;
+        checkBindings(conversion);
+
+        double* values = buffer.getValuesPtr();
         for (size_t i = 0; i < input_vars_.size(); ++i) {
-            forge::NodeId node_id = conversion_result_.input_nodes[i];
-            double val = xad::value(*input_vars_[i]);
-            buffer_->setValue(node_id, val);
+            values[conversion.input_nodes[i]] = xad::value(*input_vars_[i]);
         }
 
-        // Step 2: Clear all gradients in buffer
-        buffer_->clearGradients();
+        version.primal_kernel->executeDirect(values, buffer.getGradientsPtr(), buffer.getNumNodes());
 
-        // Step 3: Seed output gradients from XAD (reverse mode AD initialization)
-        double* gradients = buffer_->getGradientsPtr();
         for (size_t i = 0; i < output_vars_.size(); ++i) {
-            forge::NodeId node_id = conversion_result_.output_nodes[i];
-            double grad = xad::derivative(*output_vars_[i]);
-            gradients[node_id] = grad;
+            xad::value(*output_vars_[i]) = values[conversion.output_nodes[i]];
         }
+    }
+
+    void executeCompiledKernel(CompiledVersion& version) {
+        const ConversionResult& conversion = version.conversion;
+        forge::INodeValueBuffer& buffer = *version.buffer;
 
-        // Step 4: Execute kernel to backpropagate gradients
-        kernel_->executeDirect(
-            buffer_->getValuesPtr(),
-            buffer_->getGradientsPtr(),
-            buffer_->getNumNodes());
+        checkBindings(conversion);
 
-        // Step 5: Gather - sync input gradients from Forge buffer back to XAD
+        // Step 1: Scatter - sync input values from XAD variables to Forge buffer
         for (size_t i = 0; i < input_vars_.size(); ++i) {
-            forge::NodeId node_id = conversion_result_.input_nodes[i];
-            double grad = buffer_->getGradient(node_id);
-            xad::derivative(*input_vars_[i]) = grad;
+            forge::NodeId node_id = conversion.input_nodes[i];
+            double val = xad::value(*input_vars_[i]);
+            buffer.setValue(node_id, val);
+        }
+
+        // No gradient buffer if every input is value-only: values only
+        double* gradients = buffer.getGradientsPtr();
+        if (!gradients) {
+            version.kernel->executeDirect(buffer.getValuesPtr(), gradients, buffer.getNumNodes());
+        }
+
+        // Vector-mode tapes on the scalar kernel: one sweep per direction
+        for (std::size_t d = 0; gradients && d < DIMENSION; ++d) {
+            // Step 2: Clear all gradients in buffer
+            buffer.clearGradients();
+
+            // Step 3: Seed output gradients from XAD (reverse mode AD initialization)
+            for (size_t i = 0; i < output_vars_.size(); ++i) {
+                forge::NodeId node_id = conversion.output_nodes[i];
+                double grad = component(xad::derivative(*output_vars_[i]), d);
+                gradients[node_id] += grad;  // outputs may share a node
+            }
+
+            // Step 4: Execute kernel to backpropagate gradients
+            version.kernel->executeDirect(
+                buffer.getValuesPtr(),
+                gradients,
+                buffer.getNumNodes());
+
+            // Step 5: Gather - sync input gradients from Forge buffer back to XAD
+            for (size_t i = 0; i < input_vars_.size(); ++i) {
+                if (!input_differentiable_[i]) {
+                    continue;  // value-only input
+                }
+                forge::NodeId node_id = conversion.input_nodes[i];
+                double grad = buffer.getGradient(node_id);
+                component(xad::derivative(*input_vars_[i]), d) = grad;
+            }
         }
 
         // Step 6: Sync output values back to XAD (for correct forward pass values)
         for (size_t i = 0; i < output_vars_.size(); ++i) {
-            forge::NodeId node_id = conversion_result_.output_nodes[i];
-            double val = buffer_->getValue(node_id);
+            forge::NodeId node_id = conversion.output_nodes[i];
+            double val = buffer.getValue(node_id);
             xad::value(*output_vars_[i]) = val;
         }
     }
+
+    /**
+     * @brief Reverse kernel only, on the values stored by forward()
+     *
+     * Seeds and gradients go through the bound arrays or the registered
+     * variables, as in a full computeAdjoints().
+     */
+    void executeReverseKernel(CompiledVersion& version) {
+        if (version.hybrid) {
+            executeReverseSweep(*version.hybrid, version.hybrid_workspace);
+        } else {
+            executeReverseSweep(*version.forward_reverse, *version.forward_reverse_buffer);
+        }
+    }
+
+    template<class Kernel, class State>
+    void executeReverseSweep(const Kernel& kernel, State& state) {
+        const std::size_t num_inputs = kernel.numInputs();
+        const std::size_t num_outputs = kernel.numOutputs();
+
+        std::vector<double> gradients(num_inputs);
+        if (arrays_bound_) {
+            kernel.reverse(state, arrays_.outputSeeds, gradients.data());
+            if (arrays_.inputGradients) {
+                std::copy(gradients.begin(), gradients.end(), arrays_.inputGradients);
+            }
+            return;
+        }
+
+        checkBindings(current_->conversion);
+        std::vector<double> seeds(num_outputs);
+        for (std::size_t j = 0; j < num_outputs; ++j) {
+            seeds[j] = xad::derivative(*output_vars_[j]);
+        }
+        kernel.reverse(state, seeds.data(), gradients.data());
+        for (std::size_t i = 0; i < num_inputs; ++i) {
+            if (input_differentiable_[i]) {
+                xad::derivative(*input_vars_[i]) = gradients[i];
+            }
+        }
+    }
+
+    /**
+     * @brief computeAdjoints() on the graph interpreter or a hybrid kernel
+     *
+     * One forward pass for all DIMENSION directions, then one reverse
+     * sweep per direction.
+     */
+    template<class Engine>
+    void executeDirections(const Engine& engine, typename Engine::Workspace& workspace) {
+        checkBindings(current_->conversion);
+        const std::size_t num_inputs = input_vars_.size();
+        const std::size_t num_outputs = output_vars_.size();
+
+        std::vector<double> inputs(num_inputs);
+        for (std::size_t i = 0; i < num_inputs; ++i) {
+            inputs[i] = xad::value(*input_vars_[i]);
+        }
+        std::vector<double> seeds(DIMENSION * num_outputs);
+        for (std::size_t j = 0; j < num_outputs; ++j) {
+            derivative_type& seed = xad::derivative(*output_vars_[j]);
+            for (std::size_t d = 0; d < DIMENSION; ++d) {
+                seeds[d * num_outputs + j] = component(seed, d);
+            }
+        }
+
+        std::vector<double> gradients(DIMENSION * num_inputs);
+        std::vector<double> outputs(num_outputs);
+        engine.computeAdjointDirections(workspace, inputs.data(), seeds.data(), DIMENSION,
+                                        gradients.data(), outputs.data());
+
+        for (std::size_t i = 0; i < num_inputs; ++i) {
+            if (!input_differentiable_[i]) {
+                continue;  // value-only input
+            }
+            derivative_type& adjoint = xad::derivative(*input_vars_[i]);
+            for (std::size_t d = 0; d < DIMENSION; ++d) {
+                component(adjoint, d) = gradients[d * num_inputs + i];
+            }
+        }
+        storeOutputValues(outputs);
+    }
+
+    /// Direction d of a derivative (the derivative itself for scalar tapes)
+    static auto& component(derivative_type& derivative, std::size_t d) {
+        if constexpr (DIMENSION > 1) {
+            return derivative[d];
+        } else {
+            (void)d;
+            return derivative;
+        }
+    }
+
+    /**
+     * @brief Packed reverse sweep, one adjoint direction per lane
+     *
+     * Component d of each output derivative() becomes the seed of
+     * direction d; the resulting input adjoints are written back component
+     * by component.
+     */
+    void executeVectorKernel() {
+        const BatchKernel& batch = getBatchKernel();
+        checkBindings(current_->conversion);
+        const std::size_t num_inputs = input_vars_.size();
+        const std::size_t num_outputs = output_vars_.size();
+
+        std::vector<double> inputs(num_inputs);
+        for (std::size_t i = 0; i < num_inputs; ++i) {
+            inputs[i] = xad::value(*input_vars_[i]);
+        }
+        std::vector<double> seeds(DIMENSION * num_outputs);
+        for (std::size_t j = 0; j < num_outputs; ++j) {
+            derivative_type& seed = xad::derivative(*output_vars_[j]);
+            for (std::size_t d = 0; d < DIMENSION; ++d) {
+                seeds[d * num_outputs + j] = component(seed, d);
+            }
+        }
+
+        std::vector<double> gradients(DIMENSION * num_inputs);
+        std::vector<double> outputs(num_outputs);
+        batch.computeAdjointDirections(*current_->batch_buffer, inputs.data(), seeds.data(),
+                                       DIMENSION, gradients.data(), outputs.data());
+
+        for (std::size_t i = 0; i < num_inputs; ++i) {
+            if (!input_differentiable_[i]) {
+                continue;  // value-only input
+            }
+            derivative_type& adjoint = xad::derivative(*input_vars_[i]);
+            for (std::size_t d = 0; d < DIMENSION; ++d) {
+                component(adjoint, d) = gradients[d * num_inputs + i];
+            }
+        }
+        storeOutputValues(outputs);
+    }
 };
 
 } // namespace forge_xad
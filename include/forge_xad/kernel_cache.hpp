@@ -0,0 +1,85 @@
+#pragma once
+
+#include "forge_xad/structural_hash.hpp"
+#include "forge_xad/xad_tape_converter.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace forge_xad {
+
+/**
+ * @brief Persistent, content-addressed cache of converted tapes
+ *
+ * Entries live in one file per key under a configurable directory, so
+ * the cache survives process restarts and can be shared by processes
+ * running the same trades. The file name is the fingerprint key (see
+ * fingerprintTape()); the entry is the converted graph, which does not
+ * depend on the instruction set the kernel is later compiled for.
+ *
+ * Each entry stores the full TapeFingerprint, the serialised graph and a
+ * checksum of it. Entries are validated on load and rejected (and
+ * deleted) when:
+ *   - the header magic or payload size/checksum do not match (corrupted)
+ *   - the format version differs (written by an older bridge - stale)
+ *   - the stored key does not match the file name (stale)
+ * An entry whose key matches but whose second hash or counts differ
+ * belongs to another recording; it is a miss and is overwritten by the
+ * next store.
+ *
+ * Forge has no way to serialise a compiled StitchedKernel, so a hit
+ * saves the conversion and the kernel is still compiled from the
+ * loaded graph.
+ *
+ * Writes go to a temporary file that is renamed into place, so readers
+ * in other processes never see a partially written entry. One instance
+ * may be shared by several JITTapes on different threads.
+ */
+class KernelCache {
+public:
+    struct Stats {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t rejected = 0;  // corrupted or stale entries
+        std::size_t stores = 0;
+    };
+
+    /**
+     * @param directory Cache directory, created if it does not exist
+     */
+    explicit KernelCache(std::string directory);
+
+    /**
+     * @brief Look up a converted tape
+     *
+     * @param fingerprint Fingerprint of the recorded tape
+     * @param result Filled on a hit, untouched otherwise
+     * @return true on a valid hit
+     */
+    bool load(const TapeFingerprint& fingerprint, ConversionResult& result);
+
+    /**
+     * @brief Store a converted tape; failures are reported but not fatal
+     */
+    void store(const TapeFingerprint& fingerprint, const ConversionResult& result);
+
+    const std::string& directory() const { return directory_; }
+
+    /// Snapshot of the counters
+    Stats stats() const;
+
+    /// Bumped whenever the entry layout or the converter output changes
+    static constexpr std::uint32_t FORMAT_VERSION = 8;
+
+private:
+    std::string entryPath(std::uint64_t tapeKey) const;
+
+    std::string directory_;
+    std::atomic<std::size_t> hits_{0};
+    std::atomic<std::size_t> misses_{0};
+    std::atomic<std::size_t> rejected_{0};
+    std::atomic<std::size_t> stores_{0};
+};
+
+} // namespace forge_xad
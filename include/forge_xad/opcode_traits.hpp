@@ -0,0 +1,24 @@
+#pragma once
+
+#include <graph/graph.hpp>
+
+namespace forge_xad {
+
+/// True if nodes with this opcode read operand a
+inline bool hasOperandA(forge::OpCode op) {
+    return op != forge::OpCode::Input && op != forge::OpCode::Constant;
+}
+
+/// True if nodes with this opcode read operand b (binary operations)
+inline bool hasOperandB(forge::OpCode op) {
+    switch (op) {
+        case forge::OpCode::Add: case forge::OpCode::Sub: case forge::OpCode::Mul:
+        case forge::OpCode::Div: case forge::OpCode::Pow: case forge::OpCode::Max:
+        case forge::OpCode::Min:
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace forge_xad
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "forge_xad/xad_tape_converter.hpp"
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace forge_xad {
+
+/**
+ * @brief Compiled reverse sweeps that stop at a tape position
+ *
+ * Compiled equivalent of Tape::computeAdjointsTo(pos): statements after
+ * pos are swept, and the adjoints of the variables live at pos are left
+ * readable per slot. Built from an unoptimized conversion made with
+ * ConversionOptions::keepSlotNodes (the optimizer may merge nodes across
+ * the position boundary, and seeds may sit on variables no output reads).
+ * Owns a primal kernel for the prefix values plus one suffix kernel per
+ * requested position, each compiled on first use; the least recently used
+ * position kernel is evicted beyond setMaxPositionKernels(). The prefix
+ * values are kept until the inputs change, so repeated sweeps of one
+ * iteration run the primal kernel once.
+ *
+ * Seeds are the current adjoints of every slot. Slots bound at pos receive
+ * their adjoint (added to their previous value if not reassigned after
+ * pos); slots first bound after pos are zeroed, as the tape does. If
+ * several slots alias the same node at pos (plain copies), the combined
+ * adjoint goes to the slot bound last.
+ */
+class PartialAdjoints {
+public:
+    /**
+     * @param conversion     Unoptimized conversion of the tape
+     * @param inputSlots     Tape input slots in registration order
+     * @param statementSlots Lhs slot of every tape statement
+     */
+    PartialAdjoints(ConversionResult conversion,
+                    std::vector<std::uint32_t> inputSlots,
+                    std::vector<std::uint32_t> statementSlots);
+    ~PartialAdjoints();
+
+    /**
+     * @brief Sweep back to position with the given input values
+     *
+     * @param position     Tape position (statements after it are swept)
+     * @param inputs       Input values in registration order
+     * @param slotAdjoints Adjoint per slot (numSlots()), updated in place
+     */
+    void computeAdjointsTo(std::size_t position, const double* inputs,
+                           std::vector<double>& slotAdjoints);
+
+    /**
+     * @brief Slots computeAdjointsTo(position, ...) reads or writes
+     *
+     * Sorted. The other entries of slotAdjoints are neither read nor
+     * changed, so callers only need to exchange these.
+     */
+    const std::vector<std::uint32_t>& touchedSlots(std::size_t position);
+
+    /**
+     * @brief Maximum number of position kernels kept
+     *
+     * The least recently swept position is evicted when a new one needs
+     * compiling and the limit is reached; lowering it evicts at once.
+     */
+    void setMaxPositionKernels(std::size_t count);
+    std::size_t getMaxPositionKernels() const { return max_kernels_; }
+
+    std::size_t numSlots() const { return conversion_.slot_to_node.size(); }
+    std::size_t numPositionKernels() const { return kernels_.size(); }
+
+private:
+    struct SlotNode {
+        std::uint32_t slot;
+        forge::NodeId node;
+    };
+
+    struct PositionKernel {
+        forge::NodeId boundary = 0;
+        std::vector<forge::NodeId> prefix_nodes;  // values copied from the primal run
+        std::vector<SlotNode> seeds;              // slot -> final node
+        std::vector<SlotNode> results;            // slot -> node at the position
+        std::vector<std::uint32_t> cleared;       // slots zeroed by the sweep
+        std::vector<std::uint32_t> touched;       // union of the three, sorted
+        std::size_t primal_run = 0;               // primal run prefix_nodes were copied from
+        std::unique_ptr<forge::StitchedKernel> kernel;
+        std::unique_ptr<forge::INodeValueBuffer> buffer;
+        std::list<std::size_t>::iterator lru_position;
+    };
+
+    PositionKernel& kernelFor(std::size_t position);
+    void updatePrimal(const double* inputs);
+
+    ConversionResult conversion_;
+    std::vector<std::uint32_t> input_slots_;
+    std::vector<std::uint32_t> statement_slots_;
+    std::unique_ptr<forge::StitchedKernel> primal_kernel_;
+    std::unique_ptr<forge::INodeValueBuffer> primal_buffer_;
+    // Kernels by position, most recently used at the front of lru_
+    std::unordered_map<std::size_t, std::unique_ptr<PositionKernel>> kernels_;
+    std::list<std::size_t> lru_;
+    std::size_t max_kernels_ = 8;
+    std::vector<double> host_adjoints_;  // seeds landing on result nodes, by node
+    std::vector<double> primal_inputs_;  // inputs of the last primal run
+    std::size_t primal_runs_ = 0;
+};
+
+} // namespace forge_xad
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "forge_xad/batch_kernel.hpp"
+#include "forge_xad/work_stealing_pool.hpp"
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace forge_xad {
+
+/**
+ * @brief Runs scenarios on all cores against one shared BatchKernel
+ *
+ * The tape is recorded and compiled once; every worker thread gets its
+ * own value/gradient buffer while sharing the read-only kernel. Scenarios
+ * are cut into chunks (a multiple of BatchKernel::LANES) which are spread
+ * over a WorkStealingPool.
+ *
+ * Usage:
+ *   forge_xad::ScenarioRunner runner(tape.getBatchKernel());
+ *   runner.run(numScenarios, inputs, outputs, gradients);
+ *
+ * The kernel must outlive the runner.
+ */
+class ScenarioRunner {
+public:
+    /**
+     * @param kernel Compiled batch kernel shared by all workers
+     * @param numThreads Number of worker threads (0 uses all hardware threads)
+     * @param chunkSize Scenarios per work item (rounded up to a multiple of LANES)
+     */
+    explicit ScenarioRunner(const BatchKernel& kernel, unsigned numThreads = 0,
+                            std::size_t chunkSize = 256);
+
+    /**
+     * @brief Per-scenario outputs and gradients
+     *
+     * Same structure-of-arrays layout as BatchKernel::execute():
+     * inputs[numInputs][numScenarios], outputs[numOutputs][numScenarios],
+     * inputGradients[numInputs][numScenarios]. outputs and inputGradients
+     * may be nullptr.
+     */
+    void run(std::size_t numScenarios, const double* inputs, double* outputs,
+             double* inputGradients, const double* outputSeeds = nullptr);
+
+    /**
+     * @brief Outputs and gradients summed over all scenarios
+     *
+     * outputSums[numOutputs] and gradientSums[numInputs] are overwritten.
+     * Either may be nullptr. Each chunk is summed on its own and the chunk
+     * sums are added in chunk order, so the result is bitwise identical for
+     * any thread count and schedule (for a given chunk size).
+     */
+    void runReduced(std::size_t numScenarios, const double* inputs, double* outputSums,
+                    double* gradientSums, const double* outputSeeds = nullptr);
+
+    unsigned numThreads() const { return pool_.size(); }
+    std::size_t chunkSize() const { return chunk_size_; }
+
+private:
+    std::size_t numChunks(std::size_t numScenarios) const {
+        return (numScenarios + chunk_size_ - 1) / chunk_size_;
+    }
+
+    const BatchKernel& kernel_;
+    std::size_t chunk_size_;
+    WorkStealingPool pool_;
+    std::vector<std::unique_ptr<forge::INodeValueBuffer>> buffers_;
+    // Per-chunk partial sums, [numChunks][numOutputs] and [numChunks][numInputs]
+    std::vector<double> chunk_outputs_;
+    std::vector<double> chunk_gradients_;
+};
+
+} // namespace forge_xad
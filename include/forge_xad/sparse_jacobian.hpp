@@ -0,0 +1,58 @@
+#pragma once
+
+#include "forge_xad/xad_tape_converter.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace forge_xad {
+
+/**
+ * @brief Output-input sparsity of a converted graph plus an output colouring
+ *
+ * Outputs that depend on disjoint sets of inputs share a colour. Seeding
+ * every output of one colour in a single reverse sweep then yields all of
+ * their Jacobian rows at once, since each input gradient receives a
+ * contribution from at most one of them.
+ */
+struct JacobianColouring {
+    std::size_t numOutputs = 0;
+    std::size_t numInputs = 0;
+
+    /// CSR pattern: inputs that output j depends on are
+    /// columns[rowOffsets[j] .. rowOffsets[j + 1]), in increasing order
+    std::vector<std::size_t> rowOffsets;
+    std::vector<std::size_t> columns;
+
+    /// Colour of each output, and the outputs of each colour (CSR)
+    std::vector<std::size_t> colours;
+    std::size_t numColours = 0;
+    std::vector<std::size_t> colourOffsets;
+    std::vector<std::size_t> colourOutputs;
+};
+
+/**
+ * @brief Jacobian in compressed sparse row form
+ *
+ * Same row/column structure as JacobianColouring; values[k] is the
+ * derivative of output j with respect to input columns[k].
+ */
+struct SparseJacobian {
+    std::size_t numRows = 0;
+    std::size_t numCols = 0;
+    std::vector<std::size_t> rowOffsets;
+    std::vector<std::size_t> columns;
+    std::vector<double> values;
+};
+
+/**
+ * @brief Compute the dependency pattern and a greedy output colouring
+ *
+ * Dependencies are propagated forward over the (topologically ordered)
+ * live nodes as bitsets over the inputs, so the cost is
+ * O(nodes * inputs / 64). Outputs are coloured greedily in registration
+ * order: each gets the first colour none of whose outputs shares an input
+ * with it.
+ */
+JacobianColouring colourJacobian(const ConversionResult& conversion);
+
+} // namespace forge_xad
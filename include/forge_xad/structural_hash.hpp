@@ -0,0 +1,165 @@
+#pragma once
+
+#include <XAD/XAD.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace forge_xad {
+
+/**
+ * @brief Incremental 64-bit structural hash
+ *
+ * FNV-style, but mixing a whole 64-bit word per step (xor, multiply,
+ * fold the high half back) instead of one byte, so fingerprinting a large
+ * tape costs one multiply per field. Used for fingerprinting tape
+ * structure and for checksumming kernel cache entries. Not cryptographic;
+ * TapeFingerprint pairs two independently seeded instances to make
+ * mistaking one recording for another unlikely.
+ */
+class StructuralHash {
+public:
+    StructuralHash() = default;
+
+    /// Independent instance: different start value, odd multiplier
+    StructuralHash(std::uint64_t seed, std::uint64_t multiplier)
+        : hash_(seed), multiplier_(multiplier) {}
+
+    void addWord(std::uint64_t word) {
+        hash_ = (hash_ ^ word) * multiplier_;
+        hash_ ^= hash_ >> 32;
+    }
+
+    void addBytes(const void* data, std::size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        std::size_t i = 0;
+        for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t)) {
+            std::uint64_t word;
+            std::memcpy(&word, bytes + i, sizeof(word));
+            addWord(word);
+        }
+        // Tail bytes and the length, so that trailing zeros are not lost
+        std::uint64_t tail = 0;
+        std::memcpy(&tail, bytes + i, size - i);
+        addWord(tail);
+        addWord(static_cast<std::uint64_t>(size));
+    }
+
+    /// Integers and enums of up to 64 bits are one word, anything else is hashed bytewise
+    template<class T>
+    void add(const T& value) {
+        if constexpr ((std::is_integral_v<T> || std::is_enum_v<T>) && sizeof(T) <= sizeof(std::uint64_t)) {
+            addWord(static_cast<std::uint64_t>(value));
+        } else {
+            addBytes(&value, sizeof(T));
+        }
+    }
+
+    /// Hash doubles by bit pattern so that -0.0 and NaN payloads are distinct
+    void addDouble(double value) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        addWord(bits);
+    }
+
+    std::uint64_t value() const { return hash_; }
+
+private:
+    std::uint64_t hash_ = 0xcbf29ce484222325ULL;
+    std::uint64_t multiplier_ = 0x9e3779b97f4a7c15ULL;
+};
+
+/**
+ * @brief Structural identity of a tape recording
+ *
+ * key() is what recordings are looked up by. A matching key is only
+ * accepted as the same recording if the whole fingerprint compares equal:
+ * a second hash of the same words under another seed and multiplier, and
+ * the exact statement, operation, input and output counts. Wrongly
+ * matching two recordings then needs both hashes to collide with equal
+ * counts.
+ */
+struct TapeFingerprint {
+    StructuralHash hash;
+    StructuralHash check{0x84222325cbf29ce4ULL, 0xc2b2ae3d27d4eb4fULL};
+    std::uint64_t statements = 0;
+    std::uint64_t operations = 0;
+    std::uint64_t inputs = 0;
+    std::uint64_t outputs = 0;
+
+    void addWord(std::uint64_t word) {
+        hash.addWord(word);
+        check.addWord(word);
+    }
+
+    std::uint64_t key() const { return hash.value(); }
+
+    bool operator==(const TapeFingerprint& other) const {
+        return hash.value() == other.hash.value() && check.value() == other.check.value() &&
+               statements == other.statements && operations == other.operations &&
+               inputs == other.inputs && outputs == other.outputs;
+    }
+    bool operator!=(const TapeFingerprint& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Structural fingerprint of an XAD tape recording
+ *
+ * Covers input and output slots, and for every statement its LHS slot,
+ * op type and operand slots. Scalar opcodes also include their constant,
+ * because it is baked into the converted graph. Partial derivatives of
+ * other opcodes are data, not structure, and are ignored.
+ */
+template<class Tape>
+TapeFingerprint fingerprintTape(const Tape& tape) {
+    TapeFingerprint h;
+
+    const auto& input_slots = tape.getInputSlots();
+    h.inputs = input_slots.size();
+    h.addWord(h.inputs);
+    for (auto slot : input_slots) {
+        h.addWord(static_cast<std::uint32_t>(slot));
+    }
+
+    const auto& statements = tape.getStatements();
+    const auto& operations = tape.getOperations();
+    const auto& op_types = tape.getOpTypes();
+    h.statements = statements.size();
+    h.operations = statements.empty() ? 0 : statements.back().first;
+    h.addWord(h.statements);
+    for (std::size_t stmt_idx = 1; stmt_idx < statements.size(); ++stmt_idx) {
+        const auto statement = statements[stmt_idx];
+        const xad::OpCode op = op_types[stmt_idx];
+        // LHS slot and op type share one word
+        h.addWord(static_cast<std::uint64_t>(static_cast<std::uint32_t>(statement.second)) |
+                  static_cast<std::uint64_t>(static_cast<std::uint16_t>(op)) << 32);
+
+        const bool is_scalar_op =
+            op == xad::OpCode::ScalarMul || op == xad::OpCode::ScalarAdd ||
+            op == xad::OpCode::ScalarSub1 || op == xad::OpCode::ScalarSub2 ||
+            op == xad::OpCode::ScalarDiv1 || op == xad::OpCode::ScalarDiv2;
+
+        for (auto op_idx = statements[stmt_idx - 1].first; op_idx < statement.first; ++op_idx) {
+            const auto operation = operations[op_idx];
+            h.addWord(static_cast<std::uint32_t>(operation.second));
+            if (is_scalar_op) {
+                const double constant = static_cast<double>(operation.first);
+                std::uint64_t bits;
+                std::memcpy(&bits, &constant, sizeof(bits));
+                h.addWord(bits);
+            }
+        }
+    }
+
+    const auto& output_slots = tape.getOutputSlots();
+    h.outputs = output_slots.size();
+    h.addWord(h.outputs);
+    for (auto slot : output_slots) {
+        h.addWord(static_cast<std::uint32_t>(slot));
+    }
+
+    return h;
+}
+
+} // namespace forge_xad
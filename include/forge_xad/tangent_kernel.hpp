@@ -0,0 +1,59 @@
+#pragma once
+
+#include "forge_xad/graph_transforms.hpp"
+#include "forge_xad/xad_tape_converter.hpp"
+#include <compiler/forge_engine.hpp>
+#include <compiler/node_value_buffers/node_value_buffer.hpp>
+#include <cstddef>
+#include <memory>
+
+namespace forge_xad {
+
+/**
+ * @brief Compiled forward (tangent) mode for a converted graph
+ *
+ * Compiles makeTangentGraph() with the AVX2 instruction set. All lanes
+ * share the same input values and each lane carries a different tangent
+ * direction, so one kernel execution propagates LANES directions. This is
+ * the cheap direction for functions with few inputs and many outputs.
+ *
+ * As with BatchKernel, mutable state lives in the buffer, so one kernel
+ * can be shared between threads that each use their own buffer.
+ */
+class TangentKernel {
+public:
+    /// Tangent directions propagated by one kernel execution
+    static constexpr std::size_t LANES = 4;
+
+    /**
+     * @throws std::exception if the graph has no tangent rule or fails to compile
+     */
+    explicit TangentKernel(const ConversionResult& conversion);
+
+    std::unique_ptr<forge::INodeValueBuffer> createBuffer() const;
+
+    /**
+     * @brief Propagate numDirections tangent directions
+     *
+     * @param buffer Buffer from createBuffer()
+     * @param inputs Input values, [numInputs]
+     * @param directions Input tangents, [numDirections][numInputs]
+     * @param numDirections Number of directions
+     * @param outputs Output values, [numOutputs] (may be nullptr)
+     * @param outputTangents Output tangents, [numDirections][numOutputs]
+     */
+    void execute(forge::INodeValueBuffer& buffer, const double* inputs,
+                 const double* directions, std::size_t numDirections,
+                 double* outputs, double* outputTangents) const;
+
+    std::size_t numInputs() const { return input_nodes_.size(); }
+    std::size_t numOutputs() const { return output_nodes_.size(); }
+
+private:
+    TangentGraph tangent_;
+    std::vector<forge::NodeId> input_nodes_;
+    std::vector<forge::NodeId> output_nodes_;
+    std::unique_ptr<forge::StitchedKernel> kernel_;
+};
+
+} // namespace forge_xad
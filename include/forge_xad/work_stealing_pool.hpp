@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace forge_xad {
+
+/**
+ * @brief Fixed-size thread pool distributing index ranges by work stealing
+ *
+ * parallelFor() splits [0, numItems) into one contiguous range per worker.
+ * A worker takes items from the front of its own range and, once that is
+ * exhausted, steals from the back of the other workers' ranges. Contiguous
+ * ranges keep each worker on neighbouring scenarios; stealing evens out
+ * workers that are slowed down by the OS or by uneven item cost.
+ *
+ * Each range is a single atomic word, so taking an item is one
+ * compare-and-swap for both the owner and a thief. Which worker runs an
+ * item is not deterministic; callers that reduce results should do so per
+ * item index (see ScenarioRunner::runReduced()).
+ */
+class WorkStealingPool {
+public:
+    /// Task signature: task(workerIndex, itemIndex)
+    using Task = std::function<void(unsigned, std::size_t)>;
+
+    /**
+     * @param numThreads Number of worker threads (0 uses all hardware threads)
+     */
+    explicit WorkStealingPool(unsigned numThreads = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(threads_.size()); }
+
+    /**
+     * @brief Run task for every item in [0, numItems) and wait for completion
+     *
+     * Rethrows the first exception thrown by a task once all items are done.
+     * numItems must fit in 32 bits.
+     */
+    void parallelFor(std::size_t numItems, const Task& task);
+
+private:
+    // One per worker, on its own cache line so that owners and thieves of
+    // different ranges do not contend. begin in the low, end in the high
+    // 32 bits.
+    struct alignas(64) Range {
+        std::atomic<std::uint64_t> bounds{0};
+    };
+
+    void workerLoop(unsigned index);
+    bool popOrSteal(unsigned index, std::size_t& item);
+
+    std::vector<std::unique_ptr<Range>> ranges_;
+    std::vector<std::thread> threads_;
+
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    const Task* task_ = nullptr;
+    std::size_t generation_ = 0;
+    std::atomic<std::size_t> remaining_{0};
+    unsigned busy_ = 0;  // workers inside the current parallelFor()
+    std::exception_ptr error_;
+    bool stop_ = false;
+};
+
+} // namespace forge_xad
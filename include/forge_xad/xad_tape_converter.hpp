@@ -1,12 +1,17 @@
 #pragma once
 
+#include "forge_xad/host_functions.hpp"
 #include <XAD/XAD.hpp>
 #include <graph/graph.hpp>
+#include <limits>
 #include <memory>
-#include <unordered_map>
+#include <vector>
 
 namespace forge_xad {
 
+/// Marks a slot that has no node (not yet assigned, or passive)
+constexpr forge::NodeId INVALID_NODE = std::numeric_limits<forge::NodeId>::max();
+
 /**
  * @brief Converts an XAD tape to a Forge graph for JIT compilation
  *
@@ -30,9 +35,10 @@ public:
      * @brief Get mapping from XAD slot to Forge node ID
      *
      * This is needed to synchronize values between XAD variables and
-     * the compiled kernel's workspace.
+     * the compiled kernel's workspace. Indexed by slot; INVALID_NODE for
+     * slots without a node.
      */
-    const std::unordered_map<unsigned int, forge::NodeId>& getSlotToNodeMap() const {
+    const std::vector<forge::NodeId>& getSlotToNodeMap() const {
         return slot_to_node_;
     }
 
@@ -51,30 +57,82 @@ public:
     }
 
 private:
-    std::unordered_map<unsigned int, forge::NodeId> slot_to_node_;
+    std::vector<forge::NodeId> slot_to_node_;
     std::vector<forge::NodeId> input_nodes_;
     std::vector<forge::NodeId> output_nodes_;
 };
 
+/**
+ * @brief Tape statement evaluated by a HostFunction instead of Forge
+ *
+ * result is an Input node of the graph that receives the host value (and
+ * is a diff input if any operand needs a gradient); the operands are
+ * listed in graph.outputs as well, so activity analysis keeps them live.
+ */
+struct HostNode {
+    xad::OpCode opcode;
+    std::vector<forge::NodeId> operands;
+    forge::NodeId result;
+};
+
 /**
  * @brief Result of tape conversion including the graph and metadata
  */
 struct ConversionResult {
     forge::Graph graph;
-    std::unordered_map<unsigned int, forge::NodeId> slot_to_node;
+    std::vector<forge::NodeId> slot_to_node;  // indexed by XAD slot, INVALID_NODE if unset
     std::vector<forge::NodeId> input_nodes;
     std::vector<forge::NodeId> output_nodes;
+
+    // Per tape statement position, for partial adjoints. Node IDs created
+    // by statement k are >= statement_first_node[k] (in conversion order;
+    // the optimizer keeps IDs), statement_nodes[k] is the node its lhs slot
+    // is bound to, INVALID_NODE if none
+    std::vector<forge::NodeId> statement_first_node;
+    std::vector<forge::NodeId> statement_nodes;
+
+    // Statements left to host functions, in tape order. A graph with host
+    // nodes cannot be compiled as a whole; see HybridKernel
+    std::vector<HostNode> host_nodes;
+};
+
+/**
+ * @brief Options for convertXadTapeToForge()
+ */
+struct ConversionOptions {
+    /// Per registered input (registration order): true if its gradient is
+    /// wanted. Empty means every input is differentiable. Value-only inputs
+    /// are left out of graph.diff_inputs, so no adjoint paths are
+    /// compiled for them.
+    std::vector<bool> differentiableInputs;
+
+    /// Host functions for opcodes Forge does not support (see HostNode).
+    /// Without one, such an opcode makes the conversion throw.
+    const HostFunctionRegistry* hostFunctions = nullptr;
+
+    /// Keep every node still bound to a slot at the end of the recording
+    /// live (it is added to graph.outputs) instead of pruning whatever no
+    /// registered output depends on. For sweeps seeded on intermediate
+    /// variables (PartialAdjoints).
+    bool keepSlotNodes = false;
 };
 
 /**
  * @brief Convert XAD tape to Forge graph (standalone function)
  *
+ * Log10, Log2, Exp2 and Cbrt have no Forge opcode and are expanded into
+ * primitives. Other unsupported opcodes
+ * become host nodes if options.hostFunctions has them (see
+ * builtinHostFunctions()) and throw std::runtime_error otherwise.
+ *
  * @tparam Real The scalar type
  * @tparam N The tape dimension
  * @param tape The XAD tape
+ * @param options Conversion options (which inputs need gradients)
  * @return Conversion result with graph and mappings
  */
 template<class Real, std::size_t N = 1>
-ConversionResult convertXadTapeToForge(const xad::Tape<Real, N>& tape);
+ConversionResult convertXadTapeToForge(const xad::Tape<Real, N>& tape,
+                                       const ConversionOptions& options = ConversionOptions());
 
 } // namespace forge_xad
@@ -0,0 +1,62 @@
+#include "forge_xad/activity_analysis.hpp"
+#include "forge_xad/opcode_traits.hpp"
+#include <vector>
+
+namespace forge_xad {
+
+ActivityStats analyzeActivity(forge::Graph& graph) {
+    ActivityStats stats;
+    const std::size_t num_nodes = graph.nodes.size();
+
+    // Backward sweep: nodes are topologically ordered, so one reverse pass
+    // over the IDs propagates liveness from outputs to their operands
+    std::vector<char> live(num_nodes, 0);
+    for (auto id : graph.outputs) {
+        live[id] = 1;
+    }
+    for (std::size_t i = num_nodes; i-- > 0;) {
+        const forge::Node& node = graph.nodes[i];
+        if (!live[i] || node.isDead) {
+            continue;
+        }
+        if (hasOperandA(node.op)) {
+            live[node.a] = 1;
+        }
+        if (hasOperandB(node.op)) {
+            live[node.b] = 1;
+        }
+    }
+
+    // Forward sweep: a node needs an adjoint only if it is live and depends
+    // on a differentiated input
+    std::vector<char> varied(num_nodes, 0);
+    for (auto id : graph.diff_inputs) {
+        varied[id] = 1;
+    }
+    for (std::size_t i = 0; i < num_nodes; ++i) {
+        forge::Node& node = graph.nodes[i];
+        if (node.op != forge::OpCode::Input && !live[i] && !node.isDead) {
+            node.isDead = true;
+            ++stats.deadNodes;
+        }
+        if (node.isDead) {
+            node.needsGradient = false;
+            continue;
+        }
+
+        if (hasOperandA(node.op)) {
+            varied[i] = varied[node.a] || (hasOperandB(node.op) && varied[node.b]);
+        }
+        // Differentiated inputs keep their flag so their gradient slot is
+        // still allocated (and reads back as zero when unused)
+        const bool needs_gradient =
+            varied[i] && (live[i] || node.op == forge::OpCode::Input);
+        if (node.needsGradient && !needs_gradient) {
+            ++stats.gradientsCleared;
+        }
+        node.needsGradient = needs_gradient;
+    }
+    return stats;
+}
+
+} // namespace forge_xad
@@ -0,0 +1,298 @@
+#include "forge_xad/batch_kernel.hpp"
+#include <compiler/compiler_config.hpp>
+#include <algorithm>
+
+namespace forge_xad {
+
+BatchKernel::BatchKernel(const ConversionResult& conversion)
+    : graph_(conversion.graph),
+      input_nodes_(conversion.input_nodes),
+      output_nodes_(conversion.output_nodes) {
+    forge::CompilerConfig config = forge::CompilerConfig::Default();
+    config.instructionSet = forge::CompilerConfig::InstructionSet::AVX2_PACKED;
+    forge::ForgeEngine engine(config);
+    kernel_ = engine.compile(graph_);
+}
+
+std::unique_ptr<forge::INodeValueBuffer> BatchKernel::createBuffer() const {
+    return forge::NodeValueBufferFactory::create(graph_, *kernel_);
+}
+
+void BatchKernel::execute(forge::INodeValueBuffer& buffer, std::size_t numScenarios,
+                          const double* inputs, double* outputs, double* inputGradients,
+                          const double* outputSeeds, std::size_t stride) const {
+    executeImpl(buffer, numScenarios, inputs, outputs, inputGradients, outputSeeds, stride);
+}
+
+void BatchKernel::execute(forge::INodeValueBuffer& buffer, std::size_t numScenarios,
+                          const float* inputs, float* outputs, float* inputGradients,
+                          const double* outputSeeds, std::size_t stride) const {
+    executeImpl(buffer, numScenarios, inputs, outputs, inputGradients, outputSeeds, stride);
+}
+
+template<class Scalar>
+void BatchKernel::executeImpl(forge::INodeValueBuffer& buffer, std::size_t numScenarios,
+                              const Scalar* inputs, Scalar* outputs, Scalar* inputGradients,
+                              const double* outputSeeds, std::size_t stride) const {
+    if (stride == 0) {
+        stride = numScenarios;
+    }
+
+    const double* values = buffer.getValuesPtr();
+    const double* gradients = buffer.getGradientsPtr();
+    const bool wantGradients = inputGradients != nullptr && gradients != nullptr;
+
+    for (std::size_t base = 0; base < numScenarios; base += LANES) {
+        const std::size_t count = std::min(LANES, numScenarios - base);
+        runBatch(buffer, base, count, inputs, stride, outputSeeds, wantGradients);
+
+        // Gather - only the lanes that hold real scenarios
+        if (outputs) {
+            for (std::size_t j = 0; j < output_nodes_.size(); ++j) {
+                const double* src = values + static_cast<std::size_t>(output_nodes_[j]) * LANES;
+                std::copy(src, src + count, outputs + j * stride + base);
+            }
+        }
+        if (wantGradients) {
+            for (std::size_t i = 0; i < input_nodes_.size(); ++i) {
+                const double* src = gradients + static_cast<std::size_t>(input_nodes_[i]) * LANES;
+                std::copy(src, src + count, inputGradients + i * stride + base);
+            }
+        }
+    }
+}
+
+void BatchKernel::executeReduced(forge::INodeValueBuffer& buffer, std::size_t numScenarios,
+                                 const double* inputs, double* outputSums, double* gradientSums,
+                                 const double* outputSeeds, std::size_t stride) const {
+    executeReducedImpl(buffer, numScenarios, inputs, outputSums, gradientSums, outputSeeds, stride);
+}
+
+void BatchKernel::executeReduced(forge::INodeValueBuffer& buffer, std::size_t numScenarios,
+                                 const float* inputs, double* outputSums, double* gradientSums,
+                                 const double* outputSeeds, std::size_t stride) const {
+    executeReducedImpl(buffer, numScenarios, inputs, outputSums, gradientSums, outputSeeds, stride);
+}
+
+template<class Scalar>
+void BatchKernel::executeReducedImpl(forge::INodeValueBuffer& buffer, std::size_t numScenarios,
+                                     const Scalar* inputs, double* outputSums, double* gradientSums,
+                                     const double* outputSeeds, std::size_t stride) const {
+    if (stride == 0) {
+        stride = numScenarios;
+    }
+
+    const double* values = buffer.getValuesPtr();
+    const double* gradients = buffer.getGradientsPtr();
+    const bool wantGradients = gradientSums != nullptr && gradients != nullptr;
+
+    for (std::size_t base = 0; base < numScenarios; base += LANES) {
+        const std::size_t count = std::min(LANES, numScenarios - base);
+        runBatch(buffer, base, count, inputs, stride, outputSeeds, wantGradients);
+
+        if (outputSums) {
+            for (std::size_t j = 0; j < output_nodes_.size(); ++j) {
+                const double* src = values + static_cast<std::size_t>(output_nodes_[j]) * LANES;
+                for (std::size_t lane = 0; lane < count; ++lane) {
+                    outputSums[j] += src[lane];
+                }
+            }
+        }
+        if (wantGradients) {
+            for (std::size_t i = 0; i < input_nodes_.size(); ++i) {
+                const double* src = gradients + static_cast<std::size_t>(input_nodes_[i]) * LANES;
+                for (std::size_t lane = 0; lane < count; ++lane) {
+                    gradientSums[i] += src[lane];
+                }
+            }
+        }
+    }
+}
+
+void BatchKernel::computeJacobian(forge::INodeValueBuffer& buffer, const double* inputs,
+                                  double* jacobian, double* outputs) const {
+    double* values = buffer.getValuesPtr();
+    double* gradients = buffer.getGradientsPtr();
+    const std::size_t num_inputs = input_nodes_.size();
+    const std::size_t num_outputs = output_nodes_.size();
+
+    // Same input set in every lane
+    for (std::size_t i = 0; i < num_inputs; ++i) {
+        double* dst = values + static_cast<std::size_t>(input_nodes_[i]) * LANES;
+        std::fill(dst, dst + LANES, inputs[i]);
+    }
+
+    if (!gradients) {
+        // No differentiable inputs: all-zero Jacobian, values still wanted
+        std::fill(jacobian, jacobian + num_outputs * num_inputs, 0.0);
+        kernel_->executeDirect(values, gradients, buffer.getNumNodes());
+    }
+
+    for (std::size_t first = 0; gradients && first < num_outputs; first += LANES) {
+        const std::size_t count = std::min(LANES, num_outputs - first);
+
+        // Lane l carries the unit seed of output first + l
+        buffer.clearGradients();
+        for (std::size_t lane = 0; lane < count; ++lane) {
+            gradients[static_cast<std::size_t>(output_nodes_[first + lane]) * LANES + lane] += 1.0;
+        }
+
+        kernel_->executeDirect(values, gradients, buffer.getNumNodes());
+
+        for (std::size_t lane = 0; lane < count; ++lane) {
+            double* row = jacobian + (first + lane) * num_inputs;
+            for (std::size_t i = 0; i < num_inputs; ++i) {
+                row[i] = gradients[static_cast<std::size_t>(input_nodes_[i]) * LANES + lane];
+            }
+        }
+    }
+
+    if (outputs) {
+        for (std::size_t j = 0; j < num_outputs; ++j) {
+            outputs[j] = values[static_cast<std::size_t>(output_nodes_[j]) * LANES];
+        }
+    }
+}
+
+void BatchKernel::computeAdjointDirections(forge::INodeValueBuffer& buffer, const double* inputs,
+                                           const double* seeds, std::size_t numDirections,
+                                           double* inputGradients, double* outputs) const {
+    double* values = buffer.getValuesPtr();
+    double* gradients = buffer.getGradientsPtr();
+    const std::size_t num_inputs = input_nodes_.size();
+    const std::size_t num_outputs = output_nodes_.size();
+
+    for (std::size_t i = 0; i < num_inputs; ++i) {
+        double* dst = values + static_cast<std::size_t>(input_nodes_[i]) * LANES;
+        std::fill(dst, dst + LANES, inputs[i]);
+    }
+
+    if (!gradients) {
+        std::fill(inputGradients, inputGradients + numDirections * num_inputs, 0.0);
+        kernel_->executeDirect(values, gradients, buffer.getNumNodes());
+    }
+
+    for (std::size_t first = 0; gradients && first < numDirections; first += LANES) {
+        const std::size_t count = std::min(LANES, numDirections - first);
+
+        // Lane l carries the seed vector of direction first + l
+        buffer.clearGradients();
+        for (std::size_t lane = 0; lane < count; ++lane) {
+            const double* seed = seeds + (first + lane) * num_outputs;
+            for (std::size_t j = 0; j < num_outputs; ++j) {
+                gradients[static_cast<std::size_t>(output_nodes_[j]) * LANES + lane] += seed[j];
+            }
+        }
+
+        kernel_->executeDirect(values, gradients, buffer.getNumNodes());
+
+        for (std::size_t lane = 0; lane < count; ++lane) {
+            double* row = inputGradients + (first + lane) * num_inputs;
+            for (std::size_t i = 0; i < num_inputs; ++i) {
+                row[i] = gradients[static_cast<std::size_t>(input_nodes_[i]) * LANES + lane];
+            }
+        }
+    }
+
+    if (outputs) {
+        for (std::size_t j = 0; j < num_outputs; ++j) {
+            outputs[j] = values[static_cast<std::size_t>(output_nodes_[j]) * LANES];
+        }
+    }
+}
+
+void BatchKernel::computeSparseJacobian(forge::INodeValueBuffer& buffer, const double* inputs,
+                                        const JacobianColouring& colouring, SparseJacobian& jacobian,
+                                        double* outputs) const {
+    double* values = buffer.getValuesPtr();
+    double* gradients = buffer.getGradientsPtr();
+
+    jacobian.numRows = colouring.numOutputs;
+    jacobian.numCols = colouring.numInputs;
+    jacobian.rowOffsets = colouring.rowOffsets;
+    jacobian.columns = colouring.columns;
+    jacobian.values.assign(colouring.columns.size(), 0.0);
+
+    for (std::size_t i = 0; i < input_nodes_.size(); ++i) {
+        double* dst = values + static_cast<std::size_t>(input_nodes_[i]) * LANES;
+        std::fill(dst, dst + LANES, inputs[i]);
+    }
+
+    if (!gradients) {
+        kernel_->executeDirect(values, gradients, buffer.getNumNodes());
+    }
+
+    for (std::size_t first = 0; gradients && first < colouring.numColours; first += LANES) {
+        const std::size_t count = std::min(LANES, colouring.numColours - first);
+
+        // Lane l seeds every output of colour first + l
+        buffer.clearGradients();
+        for (std::size_t lane = 0; lane < count; ++lane) {
+            const std::size_t colour = first + lane;
+            for (std::size_t k = colouring.colourOffsets[colour]; k < colouring.colourOffsets[colour + 1]; ++k) {
+                const std::size_t j = colouring.colourOutputs[k];
+                gradients[static_cast<std::size_t>(output_nodes_[j]) * LANES + lane] += 1.0;
+            }
+        }
+
+        kernel_->executeDirect(values, gradients, buffer.getNumNodes());
+
+        // Within a colour no two outputs share an input, so each nonzero
+        // of those rows is the lane's gradient of its column
+        for (std::size_t lane = 0; lane < count; ++lane) {
+            const std::size_t colour = first + lane;
+            for (std::size_t k = colouring.colourOffsets[colour]; k < colouring.colourOffsets[colour + 1]; ++k) {
+                const std::size_t j = colouring.colourOutputs[k];
+                for (std::size_t e = colouring.rowOffsets[j]; e < colouring.rowOffsets[j + 1]; ++e) {
+                    const std::size_t i = colouring.columns[e];
+                    jacobian.values[e] = gradients[static_cast<std::size_t>(input_nodes_[i]) * LANES + lane];
+                }
+            }
+        }
+    }
+
+    if (outputs) {
+        for (std::size_t j = 0; j < output_nodes_.size(); ++j) {
+            outputs[j] = values[static_cast<std::size_t>(output_nodes_[j]) * LANES];
+        }
+    }
+}
+
+template<class Scalar>
+void BatchKernel::runBatch(forge::INodeValueBuffer& buffer, std::size_t base, std::size_t count,
+                           const Scalar* inputs, std::size_t stride, const double* outputSeeds,
+                           bool wantGradients) const {
+    // The AVX2 buffer keeps the LANES values of a node next to each other:
+    // lane l of node n lives at index n * LANES + l
+    double* values = buffer.getValuesPtr();
+    double* gradients = buffer.getGradientsPtr();
+
+    // Step 1: Scatter - one scenario per lane, tail lanes repeat the
+    // last scenario so they stay inside the function's domain
+    for (std::size_t i = 0; i < input_nodes_.size(); ++i) {
+        const Scalar* src = inputs + i * stride + base;
+        double* dst = values + static_cast<std::size_t>(input_nodes_[i]) * LANES;
+        for (std::size_t lane = 0; lane < LANES; ++lane) {
+            dst[lane] = src[std::min(lane, count - 1)];
+        }
+    }
+
+    // Step 2: Seed output adjoints in every lane
+    if (gradients) {
+        buffer.clearGradients();
+    }
+    if (wantGradients) {
+        for (std::size_t j = 0; j < output_nodes_.size(); ++j) {
+            const double seed = outputSeeds ? outputSeeds[j] : 1.0;
+            double* dst = gradients + static_cast<std::size_t>(output_nodes_[j]) * LANES;
+            for (std::size_t lane = 0; lane < LANES; ++lane) {
+                dst[lane] += seed;
+            }
+        }
+    }
+
+    // Step 3: Execute forward + reverse for all lanes
+    kernel_->executeDirect(values, gradients, buffer.getNumNodes());
+}
+
+} // namespace forge_xad
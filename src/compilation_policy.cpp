@@ -0,0 +1,89 @@
+#include "forge_xad/compilation_policy.hpp"
+#include "forge_xad/batch_kernel.hpp"
+#include <algorithm>
+
+namespace forge_xad {
+
+CompilationDecision AlwaysCompilePolicy::decide(const TapeProfile& profile) {
+    CompilationDecision decision;
+    decision.compile = true;
+    if (profile.directions > 1) {
+        decision.instructionSet = InstructionSet::AVX2_PACKED;
+    }
+    return decision;
+}
+
+CompilationDecision NeverCompilePolicy::decide(const TapeProfile& /*profile*/) {
+    return CompilationDecision();
+}
+
+CompilationDecision ReuseThresholdPolicy::decide(const TapeProfile& profile) {
+    CompilationDecision decision = AlwaysCompilePolicy().decide(profile);
+    decision.compile = profile.evaluations >= threshold_;
+    return decision;
+}
+
+CostModelPolicy::CostModelPolicy(const Options& options) : rates_(options) {}
+
+std::size_t CostModelPolicy::sweeps(const TapeProfile& profile, InstructionSet instructionSet) {
+    const std::size_t directions = std::max<std::size_t>(profile.directions, 1);
+    if (instructionSet == InstructionSet::AVX2_PACKED) {
+        return (directions + BatchKernel::LANES - 1) / BatchKernel::LANES;
+    }
+    return directions;
+}
+
+double CostModelPolicy::predictKernelMs(const TapeProfile& profile, InstructionSet instructionSet) const {
+    const double rate = instructionSet == InstructionSet::AVX2_PACKED ? rates_.packedKernelMsPerStatement
+                                                                      : rates_.scalarKernelMsPerStatement;
+    return rate * static_cast<double>(profile.numStatements * sweeps(profile, instructionSet));
+}
+
+CompilationDecision CostModelPolicy::decide(const TapeProfile& profile) {
+    const double statements = static_cast<double>(profile.numStatements);
+    const double tape_ms = profile.tapeMs > 0.0
+                               ? profile.tapeMs
+                               : rates_.tapeMsPerStatement * statements * static_cast<double>(profile.directions);
+
+    CompilationDecision decision;
+    const double scalar_ms = predictKernelMs(profile, InstructionSet::SSE2_SCALAR);
+    const double packed_ms = predictKernelMs(profile, InstructionSet::AVX2_PACKED);
+    if (packed_ms < scalar_ms) {
+        decision.instructionSet = InstructionSet::AVX2_PACKED;
+    }
+
+    const double saving_per_call = tape_ms - std::min(scalar_ms, packed_ms);
+    const double expected_calls = rates_.reuseFactor * static_cast<double>(profile.evaluations);
+    decision.compile = expected_calls * saving_per_call > rates_.compileMsPerStatement * statements;
+    return decision;
+}
+
+void CostModelPolicy::blend(double& rate, double measured) const {
+    rate += rates_.smoothing * (measured - rate);
+}
+
+void CostModelPolicy::observeCompilation(const TapeProfile& profile, InstructionSet /*instructionSet*/,
+                                         double ms) {
+    if (profile.numStatements > 0) {
+        blend(rates_.compileMsPerStatement, ms / static_cast<double>(profile.numStatements));
+    }
+}
+
+void CostModelPolicy::observeKernelRun(const TapeProfile& profile, InstructionSet instructionSet, double ms) {
+    const std::size_t work = profile.numStatements * sweeps(profile, instructionSet);
+    if (work == 0) {
+        return;
+    }
+    double& rate = instructionSet == InstructionSet::AVX2_PACKED ? rates_.packedKernelMsPerStatement
+                                                                 : rates_.scalarKernelMsPerStatement;
+    blend(rate, ms / static_cast<double>(work));
+}
+
+void CostModelPolicy::observeTapeRun(const TapeProfile& profile, double ms) {
+    const std::size_t work = profile.numStatements * std::max<std::size_t>(profile.directions, 1);
+    if (work > 0) {
+        blend(rates_.tapeMsPerStatement, ms / static_cast<double>(work));
+    }
+}
+
+} // namespace forge_xad
@@ -0,0 +1,54 @@
+#include "forge_xad/forward_reverse_kernel.hpp"
+#include <compiler/compiler_config.hpp>
+
+namespace forge_xad {
+
+ForwardReverseKernel::ForwardReverseKernel(const ConversionResult& conversion)
+    : primal_(makePrimalGraph(conversion.graph)),
+      adjoint_(makeAdjointGraph(conversion)),
+      input_nodes_(conversion.input_nodes),
+      output_nodes_(conversion.output_nodes) {
+    forge::CompilerConfig config = forge::CompilerConfig::Default();
+    config.instructionSet = forge::CompilerConfig::InstructionSet::SSE2_SCALAR;
+    forge::ForgeEngine engine(config);
+    forward_kernel_ = engine.compile(primal_);
+    reverse_kernel_ = engine.compile(adjoint_.graph);
+}
+
+std::unique_ptr<forge::INodeValueBuffer> ForwardReverseKernel::createBuffer() const {
+    return forge::NodeValueBufferFactory::create(adjoint_.graph, *reverse_kernel_);
+}
+
+void ForwardReverseKernel::forward(forge::INodeValueBuffer& buffer, const double* inputs,
+                                   double* outputs) const {
+    // Scalar buffers are indexed by node ID, and the primal nodes come
+    // first in the adjoint graph
+    double* values = buffer.getValuesPtr();
+    for (std::size_t i = 0; i < input_nodes_.size(); ++i) {
+        values[input_nodes_[i]] = inputs[i];
+    }
+
+    forward_kernel_->executeDirect(values, buffer.getGradientsPtr(), primal_.nodes.size());
+
+    if (outputs) {
+        for (std::size_t j = 0; j < output_nodes_.size(); ++j) {
+            outputs[j] = values[output_nodes_[j]];
+        }
+    }
+}
+
+void ForwardReverseKernel::reverse(forge::INodeValueBuffer& buffer, const double* seeds,
+                                   double* inputGradients) const {
+    double* values = buffer.getValuesPtr();
+    for (std::size_t j = 0; j < output_nodes_.size(); ++j) {
+        values[adjoint_.output_seeds[j]] = seeds ? seeds[j] : 1.0;
+    }
+
+    reverse_kernel_->executeDirect(values, buffer.getGradientsPtr(), buffer.getNumNodes());
+
+    for (std::size_t i = 0; i < input_nodes_.size(); ++i) {
+        inputGradients[i] = values[adjoint_.input_adjoints[i]];
+    }
+}
+
+} // namespace forge_xad
@@ -0,0 +1,309 @@
+#include "forge_xad/graph_interpreter.hpp"
+#include "forge_xad/opcode_traits.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace forge_xad {
+
+namespace {
+
+constexpr std::uint32_t kNoSlot = std::numeric_limits<std::uint32_t>::max();
+
+bool isInterpretable(forge::OpCode op) {
+    switch (op) {
+        case forge::OpCode::Add: case forge::OpCode::Sub: case forge::OpCode::Mul:
+        case forge::OpCode::Div: case forge::OpCode::Neg: case forge::OpCode::Exp:
+        case forge::OpCode::Log: case forge::OpCode::Sqrt: case forge::OpCode::Sin:
+        case forge::OpCode::Cos: case forge::OpCode::Tan: case forge::OpCode::Abs:
+        case forge::OpCode::Square: case forge::OpCode::Recip: case forge::OpCode::Pow:
+        case forge::OpCode::Max: case forge::OpCode::Min:
+            return true;
+        default:
+            return false;
+    }
+}
+
+template<std::size_t W, class F>
+inline void forLanes(F f) {
+    for (std::size_t l = 0; l < W; ++l) {
+        f(l);
+    }
+}
+
+} // namespace
+
+GraphInterpreter::GraphInterpreter(const ConversionResult& conversion) {
+    const forge::Graph& graph = conversion.graph;
+    std::vector<std::uint32_t> slot(graph.nodes.size(), kNoSlot);
+
+    for (std::size_t id = 0; id < graph.nodes.size(); ++id) {
+        const forge::Node& node = graph.nodes[id];
+        if (node.isDead) {
+            continue;
+        }
+        slot[id] = static_cast<std::uint32_t>(num_slots_++);
+        if (node.op == forge::OpCode::Input) {
+            continue;
+        }
+        if (node.op == forge::OpCode::Constant) {
+            constant_slots_.push_back(slot[id]);
+            constant_values_.push_back(graph.constPool[static_cast<std::size_t>(node.imm)]);
+            continue;
+        }
+        if (!isInterpretable(node.op)) {
+            throw std::runtime_error("GraphInterpreter: no rule for Forge OpCode=" +
+                                     std::to_string(static_cast<int>(node.op)));
+        }
+
+        Instruction instruction{};
+        instruction.op = node.op;
+        instruction.dst = slot[id];
+        instruction.a = slot[node.a];
+        instruction.b = hasOperandB(node.op) ? slot[node.b] : instruction.a;
+        instruction.gradA = graph.nodes[node.a].needsGradient;
+        instruction.gradB = hasOperandB(node.op) && graph.nodes[node.b].needsGradient;
+        forward_.push_back(instruction);
+    }
+
+    for (auto it = forward_.rbegin(); it != forward_.rend(); ++it) {
+        if (it->gradA || it->gradB) {
+            reverse_.push_back(*it);
+        }
+    }
+
+    for (auto id : conversion.input_nodes) {
+        input_slots_.push_back(slot[id]);
+        differentiable_.push_back(graph.nodes[id].needsGradient);
+    }
+    for (auto id : conversion.output_nodes) {
+        output_slots_.push_back(slot[id]);
+    }
+}
+
+GraphInterpreter::Workspace GraphInterpreter::createWorkspace(std::size_t lanes) const {
+    if (lanes != 1 && lanes != LANES) {
+        throw std::runtime_error("GraphInterpreter: workspaces have 1 or LANES lanes");
+    }
+    Workspace workspace;
+    workspace.lanes = lanes;
+    workspace.values.assign(num_slots_ * lanes, 0.0);
+    workspace.adjoints.assign(num_slots_ * lanes, 0.0);
+    for (std::size_t k = 0; k < constant_slots_.size(); ++k) {
+        double* dst = workspace.values.data() + constant_slots_[k] * lanes;
+        std::fill(dst, dst + lanes, constant_values_[k]);
+    }
+    return workspace;
+}
+
+template<std::size_t W>
+void GraphInterpreter::runForward(double* v) const {
+    for (const Instruction& in : forward_) {
+        double* r = v + in.dst * W;
+        const double* x = v + in.a * W;
+        const double* y = v + in.b * W;
+        switch (in.op) {
+            case forge::OpCode::Add: forLanes<W>([&](std::size_t l) { r[l] = x[l] + y[l]; }); break;
+            case forge::OpCode::Sub: forLanes<W>([&](std::size_t l) { r[l] = x[l] - y[l]; }); break;
+            case forge::OpCode::Mul: forLanes<W>([&](std::size_t l) { r[l] = x[l] * y[l]; }); break;
+            case forge::OpCode::Div: forLanes<W>([&](std::size_t l) { r[l] = x[l] / y[l]; }); break;
+            case forge::OpCode::Neg: forLanes<W>([&](std::size_t l) { r[l] = -x[l]; }); break;
+            case forge::OpCode::Exp: forLanes<W>([&](std::size_t l) { r[l] = std::exp(x[l]); }); break;
+            case forge::OpCode::Log: forLanes<W>([&](std::size_t l) { r[l] = std::log(x[l]); }); break;
+            case forge::OpCode::Sqrt: forLanes<W>([&](std::size_t l) { r[l] = std::sqrt(x[l]); }); break;
+            case forge::OpCode::Sin: forLanes<W>([&](std::size_t l) { r[l] = std::sin(x[l]); }); break;
+            case forge::OpCode::Cos: forLanes<W>([&](std::size_t l) { r[l] = std::cos(x[l]); }); break;
+            case forge::OpCode::Tan: forLanes<W>([&](std::size_t l) { r[l] = std::tan(x[l]); }); break;
+            case forge::OpCode::Abs: forLanes<W>([&](std::size_t l) { r[l] = std::abs(x[l]); }); break;
+            case forge::OpCode::Square: forLanes<W>([&](std::size_t l) { r[l] = x[l] * x[l]; }); break;
+            case forge::OpCode::Recip: forLanes<W>([&](std::size_t l) { r[l] = 1.0 / x[l]; }); break;
+            case forge::OpCode::Pow: forLanes<W>([&](std::size_t l) { r[l] = std::pow(x[l], y[l]); }); break;
+            case forge::OpCode::Max: forLanes<W>([&](std::size_t l) { r[l] = std::max(x[l], y[l]); }); break;
+            case forge::OpCode::Min: forLanes<W>([&](std::size_t l) { r[l] = std::min(x[l], y[l]); }); break;
+            default: break;  // rejected by the constructor
+        }
+    }
+}
+
+template<std::size_t W>
+void GraphInterpreter::runReverse(const double* v, double* g) const {
+    for (const Instruction& in : reverse_) {
+        const double* d = g + in.dst * W;
+        const double* r = v + in.dst * W;
+        const double* x = v + in.a * W;
+        const double* y = v + in.b * W;
+        double* ga = g + in.a * W;
+        double* gb = g + in.b * W;
+        switch (in.op) {
+            case forge::OpCode::Add:
+                if (in.gradA) forLanes<W>([&](std::size_t l) { ga[l] += d[l]; });
+                if (in.gradB) forLanes<W>([&](std::size_t l) { gb[l] += d[l]; });
+                break;
+            case forge::OpCode::Sub:
+                if (in.gradA) forLanes<W>([&](std::size_t l) { ga[l] += d[l]; });
+                if (in.gradB) forLanes<W>([&](std::size_t l) { gb[l] -= d[l]; });
+                break;
+            case forge::OpCode::Mul:
+                if (in.gradA) forLanes<W>([&](std::size_t l) { ga[l] += d[l] * y[l]; });
+                if (in.gradB) forLanes<W>([&](std::size_t l) { gb[l] += d[l] * x[l]; });
+                break;
+            case forge::OpCode::Div:
+                if (in.gradA) forLanes<W>([&](std::size_t l) { ga[l] += d[l] / y[l]; });
+                if (in.gradB) forLanes<W>([&](std::size_t l) { gb[l] -= d[l] / y[l] * r[l]; });
+                break;
+            case forge::OpCode::Neg: forLanes<W>([&](std::size_t l) { ga[l] -= d[l]; }); break;
+            case forge::OpCode::Exp: forLanes<W>([&](std::size_t l) { ga[l] += d[l] * r[l]; }); break;
+            case forge::OpCode::Log: forLanes<W>([&](std::size_t l) { ga[l] += d[l] / x[l]; }); break;
+            case forge::OpCode::Sqrt: forLanes<W>([&](std::size_t l) { ga[l] += 0.5 * d[l] / r[l]; }); break;
+            case forge::OpCode::Sin: forLanes<W>([&](std::size_t l) { ga[l] += d[l] * std::cos(x[l]); }); break;
+            case forge::OpCode::Cos: forLanes<W>([&](std::size_t l) { ga[l] -= d[l] * std::sin(x[l]); }); break;
+            case forge::OpCode::Tan: forLanes<W>([&](std::size_t l) { ga[l] += d[l] * (1.0 + r[l] * r[l]); }); break;
+            case forge::OpCode::Abs:
+                forLanes<W>([&](std::size_t l) { ga[l] += x[l] >= 0.0 ? d[l] : -d[l]; });
+                break;
+            case forge::OpCode::Square: forLanes<W>([&](std::size_t l) { ga[l] += d[l] * 2.0 * x[l]; }); break;
+            case forge::OpCode::Recip: forLanes<W>([&](std::size_t l) { ga[l] -= d[l] * r[l] * r[l]; }); break;
+            case forge::OpCode::Pow:
+                if (in.gradA) forLanes<W>([&](std::size_t l) { ga[l] += d[l] * y[l] * std::pow(x[l], y[l] - 1.0); });
+                if (in.gradB) forLanes<W>([&](std::size_t l) { gb[l] += d[l] * r[l] * std::log(x[l]); });
+                break;
+            case forge::OpCode::Max:
+            case forge::OpCode::Min: {
+                // XAD's rule: a gets the whole adjoint if a >= b (Max) or
+                // a <= b (Min), b otherwise
+                const bool is_max = in.op == forge::OpCode::Max;
+                forLanes<W>([&](std::size_t l) {
+                    const bool select_a = is_max ? x[l] >= y[l] : x[l] <= y[l];
+                    const double to_a = select_a ? d[l] : 0.0;
+                    const double to_b = select_a ? 0.0 : d[l];
+                    if (in.gradA) ga[l] += to_a;
+                    if (in.gradB) gb[l] += to_b;
+                });
+                break;
+            }
+            default: break;
+        }
+    }
+}
+
+void GraphInterpreter::forward(Workspace& workspace) const {
+    if (workspace.lanes == LANES) {
+        runForward<LANES>(workspace.values.data());
+    } else {
+        runForward<1>(workspace.values.data());
+    }
+}
+
+void GraphInterpreter::reverse(Workspace& workspace) const {
+    if (workspace.lanes == LANES) {
+        runReverse<LANES>(workspace.values.data(), workspace.adjoints.data());
+    } else {
+        runReverse<1>(workspace.values.data(), workspace.adjoints.data());
+    }
+}
+
+void GraphInterpreter::evaluate(Workspace& workspace, const double* inputs, double* outputs) const {
+    const std::size_t lanes = workspace.lanes;
+    double* values = workspace.values.data();
+    for (std::size_t i = 0; i < input_slots_.size(); ++i) {
+        std::fill(values + input_slots_[i] * lanes, values + (input_slots_[i] + 1) * lanes, inputs[i]);
+    }
+    forward(workspace);
+    for (std::size_t j = 0; j < output_slots_.size(); ++j) {
+        outputs[j] = values[output_slots_[j] * lanes];
+    }
+}
+
+void GraphInterpreter::computeAdjointDirections(Workspace& workspace, const double* inputs,
+                                                const double* seeds, std::size_t numDirections,
+                                                double* inputGradients, double* outputs) const {
+    // Every lane holds the same input values; lanes carry directions
+    const std::size_t lanes = workspace.lanes;
+    double* values = workspace.values.data();
+    double* adjoints = workspace.adjoints.data();
+    const std::size_t num_inputs = input_slots_.size();
+    const std::size_t num_outputs = output_slots_.size();
+
+    for (std::size_t i = 0; i < num_inputs; ++i) {
+        std::fill(values + input_slots_[i] * lanes, values + (input_slots_[i] + 1) * lanes, inputs[i]);
+    }
+    forward(workspace);
+
+    for (std::size_t first = 0; first < numDirections; first += lanes) {
+        const std::size_t count = std::min(lanes, numDirections - first);
+        std::fill(workspace.adjoints.begin(), workspace.adjoints.end(), 0.0);
+        for (std::size_t lane = 0; lane < count; ++lane) {
+            for (std::size_t j = 0; j < num_outputs; ++j) {
+                adjoints[output_slots_[j] * lanes + lane] +=
+                    seeds ? seeds[(first + lane) * num_outputs + j] : 1.0;  // outputs may share a slot
+            }
+        }
+        reverse(workspace);
+        if (inputGradients) {
+            for (std::size_t lane = 0; lane < count; ++lane) {
+                double* row = inputGradients + (first + lane) * num_inputs;
+                for (std::size_t i = 0; i < num_inputs; ++i) {
+                    row[i] = differentiable_[i] ? adjoints[input_slots_[i] * lanes + lane] : 0.0;
+                }
+            }
+        }
+    }
+
+    if (outputs) {
+        for (std::size_t j = 0; j < num_outputs; ++j) {
+            outputs[j] = values[output_slots_[j] * lanes];
+        }
+    }
+}
+
+void GraphInterpreter::execute(Workspace& workspace, std::size_t numScenarios, const double* inputs,
+                               double* outputs, double* inputGradients,
+                               const double* outputSeeds) const {
+    const std::size_t lanes = workspace.lanes;
+    double* values = workspace.values.data();
+    double* adjoints = workspace.adjoints.data();
+    const std::size_t num_inputs = input_slots_.size();
+    const std::size_t num_outputs = output_slots_.size();
+
+    for (std::size_t first = 0; first < numScenarios; first += lanes) {
+        const std::size_t count = std::min(lanes, numScenarios - first);
+
+        // Tail lanes repeat the last scenario and are not written back
+        for (std::size_t i = 0; i < num_inputs; ++i) {
+            double* dst = values + input_slots_[i] * lanes;
+            for (std::size_t lane = 0; lane < lanes; ++lane) {
+                dst[lane] = inputs[i * numScenarios + first + std::min(lane, count - 1)];
+            }
+        }
+        forward(workspace);
+
+        if (inputGradients) {
+            std::fill(workspace.adjoints.begin(), workspace.adjoints.end(), 0.0);
+            for (std::size_t j = 0; j < num_outputs; ++j) {
+                double* dst = adjoints + output_slots_[j] * lanes;
+                for (std::size_t lane = 0; lane < lanes; ++lane) {
+                    dst[lane] += outputSeeds ? outputSeeds[j] : 1.0;
+                }
+            }
+            reverse(workspace);
+            for (std::size_t i = 0; i < num_inputs; ++i) {
+                const double* src = adjoints + input_slots_[i] * lanes;
+                for (std::size_t lane = 0; lane < count; ++lane) {
+                    inputGradients[i * numScenarios + first + lane] = differentiable_[i] ? src[lane] : 0.0;
+                }
+            }
+        }
+        if (outputs) {
+            for (std::size_t j = 0; j < num_outputs; ++j) {
+                const double* src = values + output_slots_[j] * lanes;
+                for (std::size_t lane = 0; lane < count; ++lane) {
+                    outputs[j * numScenarios + first + lane] = src[lane];
+                }
+            }
+        }
+    }
+}
+
+} // namespace forge_xad
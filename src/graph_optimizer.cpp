@@ -0,0 +1,305 @@
+#include "forge_xad/graph_optimizer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace forge_xad {
+
+namespace {
+
+bool isUnary(forge::OpCode op) {
+    switch (op) {
+        case forge::OpCode::Neg: case forge::OpCode::Exp: case forge::OpCode::Log:
+        case forge::OpCode::Sqrt: case forge::OpCode::Sin: case forge::OpCode::Cos:
+        case forge::OpCode::Tan: case forge::OpCode::Abs: case forge::OpCode::Square:
+        case forge::OpCode::Recip:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool isBinary(forge::OpCode op) {
+    switch (op) {
+        case forge::OpCode::Add: case forge::OpCode::Sub: case forge::OpCode::Mul:
+        case forge::OpCode::Div: case forge::OpCode::Pow: case forge::OpCode::Max:
+        case forge::OpCode::Min:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Max and Min are not: at a tie their adjoint goes to a fixed operand (as in
+// XAD), so max(a, b) and max(b, a) differentiate differently
+bool isCommutative(forge::OpCode op) {
+    return op == forge::OpCode::Add || op == forge::OpCode::Mul;
+}
+
+// Evaluates a supported opcode; ok=false for anything else
+double evaluate(forge::OpCode op, double a, double b, bool& ok) {
+    ok = true;
+    switch (op) {
+        case forge::OpCode::Add: return a + b;
+        case forge::OpCode::Sub: return a - b;
+        case forge::OpCode::Mul: return a * b;
+        case forge::OpCode::Div: return a / b;
+        case forge::OpCode::Pow: return std::pow(a, b);
+        case forge::OpCode::Max: return std::max(a, b);
+        case forge::OpCode::Min: return std::min(a, b);
+        case forge::OpCode::Neg: return -a;
+        case forge::OpCode::Exp: return std::exp(a);
+        case forge::OpCode::Log: return std::log(a);
+        case forge::OpCode::Sqrt: return std::sqrt(a);
+        case forge::OpCode::Sin: return std::sin(a);
+        case forge::OpCode::Cos: return std::cos(a);
+        case forge::OpCode::Tan: return std::tan(a);
+        case forge::OpCode::Abs: return std::abs(a);
+        case forge::OpCode::Square: return a * a;
+        case forge::OpCode::Recip: return 1.0 / a;
+        default:
+            ok = false;
+            return 0.0;
+    }
+}
+
+std::uint64_t bitsOf(double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+struct NodeKey {
+    forge::OpCode op;
+    forge::NodeId a;
+    forge::NodeId b;
+
+    bool operator==(const NodeKey& other) const {
+        return op == other.op && a == other.a && b == other.b;
+    }
+};
+
+struct NodeKeyHash {
+    std::size_t operator()(const NodeKey& key) const {
+        std::uint64_t h = static_cast<std::uint64_t>(key.op);
+        h = h * 0x9e3779b97f4a7c15ULL ^ key.a;
+        h = h * 0x9e3779b97f4a7c15ULL ^ key.b;
+        return static_cast<std::size_t>(h ^ (h >> 29));
+    }
+};
+
+class Optimizer {
+public:
+    Optimizer(ConversionResult& conversion, const GraphOptimizerOptions& options)
+        : conversion_(conversion), graph_(conversion.graph), options_(options),
+          replacement_(graph_.nodes.size()) {
+        for (forge::NodeId id = 0; id < graph_.nodes.size(); ++id) {
+            replacement_[id] = id;
+            const forge::Node& node = graph_.nodes[id];
+            if (node.op == forge::OpCode::Constant && !node.isDead) {
+                constants_.emplace(bitsOf(constantValue(id)), id);
+            }
+        }
+    }
+
+    GraphOptimizerStats run() {
+        for (forge::NodeId id = 0; id < graph_.nodes.size(); ++id) {
+            forge::Node& node = graph_.nodes[id];
+            if (node.isDead || node.op == forge::OpCode::Input || node.op == forge::OpCode::Constant) {
+                continue;
+            }
+            const bool unary = isUnary(node.op);
+            if (!unary && !isBinary(node.op)) {
+                continue;  // unknown opcode: leave untouched
+            }
+
+            node.a = replacement_[node.a];
+            if (!unary) {
+                node.b = replacement_[node.b];
+            }
+
+            if (options_.constantFolding && fold(id)) {
+                continue;
+            }
+            if (options_.algebraicSimplification && simplify(id)) {
+                continue;
+            }
+            if (options_.commonSubexpressionElimination) {
+                eliminateCommon(id);
+            }
+        }
+
+        // Redirect everything that refers to nodes by ID
+        for (auto& id : graph_.outputs) {
+            id = replacement_[id];
+        }
+        for (auto& id : conversion_.output_nodes) {
+            id = replacement_[id];
+        }
+        for (auto* ids : {&conversion_.slot_to_node, &conversion_.statement_nodes}) {
+            for (auto& id : *ids) {
+                if (id != INVALID_NODE) {
+                    id = replacement_[id];
+                }
+            }
+        }
+        for (auto& host : conversion_.host_nodes) {
+            for (auto& id : host.operands) {
+                id = replacement_[id];
+            }
+        }
+        return stats_;
+    }
+
+private:
+    ConversionResult& conversion_;
+    forge::Graph& graph_;
+    const GraphOptimizerOptions& options_;
+    GraphOptimizerStats stats_;
+    std::vector<forge::NodeId> replacement_;
+    std::unordered_map<std::uint64_t, forge::NodeId> constants_;
+    std::unordered_map<NodeKey, forge::NodeId, NodeKeyHash> expressions_;
+
+    double constantValue(forge::NodeId id) const {
+        return graph_.constPool[static_cast<std::size_t>(graph_.nodes[id].imm)];
+    }
+
+    bool isConstant(forge::NodeId id) const {
+        return graph_.nodes[id].op == forge::OpCode::Constant;
+    }
+
+    bool isConstant(forge::NodeId id, double value) const {
+        return isConstant(id) && constantValue(id) == value;
+    }
+
+    void replace(forge::NodeId id, forge::NodeId with) {
+        replacement_[id] = with;
+        graph_.nodes[id].isDead = true;
+    }
+
+    // Turns node id into a constant, or reuses an existing equal constant
+    void makeConstant(forge::NodeId id, double value) {
+        auto it = constants_.find(bitsOf(value));
+        if (it != constants_.end()) {
+            replace(id, it->second);
+            return;
+        }
+        forge::Node& node = graph_.nodes[id];
+        node.op = forge::OpCode::Constant;
+        node.a = 0;
+        node.b = 0;
+        node.imm = static_cast<double>(graph_.constPool.size());
+        node.isActive = false;
+        node.needsGradient = false;
+        graph_.constPool.push_back(value);
+        constants_.emplace(bitsOf(value), id);
+    }
+
+    // Rewrites node id in place as a unary op (canonical form)
+    void makeUnary(forge::NodeId id, forge::OpCode op, forge::NodeId operand) {
+        forge::Node& node = graph_.nodes[id];
+        node.op = op;
+        node.a = operand;
+        node.b = 0;
+        node.needsGradient = graph_.nodes[operand].needsGradient;
+        ++stats_.canonicalized;
+    }
+
+    bool fold(forge::NodeId id) {
+        const forge::Node& node = graph_.nodes[id];
+        const bool unary = isUnary(node.op);
+        if (!isConstant(node.a) || (!unary && !isConstant(node.b))) {
+            return false;
+        }
+        bool ok;
+        const double value = evaluate(node.op, constantValue(node.a),
+                                      unary ? 0.0 : constantValue(node.b), ok);
+        if (!ok) {
+            return false;
+        }
+        makeConstant(id, value);
+        ++stats_.constantsFolded;
+        return true;
+    }
+
+    // Returns true if the node was removed; canonical rewrites loop so that
+    // e.g. 0 - (-x) collapses fully
+    bool simplify(forge::NodeId id) {
+        for (int round = 0; round < 4; ++round) {
+            forge::Node& node = graph_.nodes[id];
+            const forge::NodeId a = node.a;
+            const forge::NodeId b = node.b;
+
+            switch (node.op) {
+                case forge::OpCode::Add:
+                    if (isConstant(b, 0.0)) { return removeWith(id, a); }
+                    if (isConstant(a, 0.0)) { return removeWith(id, b); }
+                    return false;
+                case forge::OpCode::Sub:
+                    if (isConstant(b, 0.0)) { return removeWith(id, a); }
+                    if (a == b) {
+                        makeConstant(id, 0.0);
+                        ++stats_.simplified;
+                        return true;
+                    }
+                    if (isConstant(a, 0.0)) { makeUnary(id, forge::OpCode::Neg, b); continue; }
+                    return false;
+                case forge::OpCode::Mul:
+                    if (isConstant(b, 1.0)) { return removeWith(id, a); }
+                    if (isConstant(a, 1.0)) { return removeWith(id, b); }
+                    if (isConstant(a, -1.0)) { makeUnary(id, forge::OpCode::Neg, b); continue; }
+                    if (isConstant(b, -1.0)) { makeUnary(id, forge::OpCode::Neg, a); continue; }
+                    if (a == b) { makeUnary(id, forge::OpCode::Square, a); continue; }
+                    return false;
+                case forge::OpCode::Div:
+                    if (isConstant(b, 1.0)) { return removeWith(id, a); }
+                    if (isConstant(a, 1.0)) { makeUnary(id, forge::OpCode::Recip, b); continue; }
+                    return false;
+                case forge::OpCode::Pow:
+                    if (isConstant(b, 1.0)) { return removeWith(id, a); }
+                    if (isConstant(b, 2.0)) { makeUnary(id, forge::OpCode::Square, a); continue; }
+                    if (isConstant(b, -1.0)) { makeUnary(id, forge::OpCode::Recip, a); continue; }
+                    return false;
+                case forge::OpCode::Neg:
+                    if (graph_.nodes[a].op == forge::OpCode::Neg) {
+                        return removeWith(id, graph_.nodes[a].a);
+                    }
+                    return false;
+                default:
+                    return false;
+            }
+        }
+        return false;
+    }
+
+    bool removeWith(forge::NodeId id, forge::NodeId with) {
+        replace(id, with);
+        ++stats_.simplified;
+        return true;
+    }
+
+    void eliminateCommon(forge::NodeId id) {
+        const forge::Node& node = graph_.nodes[id];
+        NodeKey key{node.op, node.a, isUnary(node.op) ? 0 : node.b};
+        if (isCommutative(node.op) && key.b < key.a) {
+            std::swap(key.a, key.b);
+        }
+        auto inserted = expressions_.emplace(key, id);
+        if (!inserted.second) {
+            replace(id, inserted.first->second);
+            ++stats_.subexpressionsEliminated;
+        }
+    }
+};
+
+} // namespace
+
+GraphOptimizerStats optimizeGraph(ConversionResult& conversion, const GraphOptimizerOptions& options) {
+    Optimizer optimizer(conversion, options);
+    return optimizer.run();
+}
+
+} // namespace forge_xad
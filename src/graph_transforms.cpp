@@ -0,0 +1,396 @@
+#include "forge_xad/graph_transforms.hpp"
+#include "forge_xad/activity_analysis.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace forge_xad {
+
+forge::Graph makePrimalGraph(const forge::Graph& graph) {
+    forge::Graph primal = graph;
+    primal.diff_inputs.clear();
+    for (auto& node : primal.nodes) {
+        node.needsGradient = false;
+    }
+    return primal;
+}
+
+forge::Graph makeSuffixGraph(const forge::Graph& graph, forge::NodeId boundary) {
+    forge::Graph suffix = graph;
+    suffix.diff_inputs.clear();
+    for (forge::NodeId id = 0; id < boundary && id < suffix.nodes.size(); ++id) {
+        forge::Node& node = suffix.nodes[id];
+        if (node.isDead || node.op == forge::OpCode::Constant) {
+            continue;
+        }
+        node.op = forge::OpCode::Input;
+        node.a = 0;
+        node.b = 0;
+        node.c = 0;
+        node.isActive = true;
+        node.needsGradient = true;
+        suffix.diff_inputs.push_back(id);
+    }
+
+    // Prefix nodes the suffix never reads stay as (unused) inputs; their
+    // former operands are no longer referenced
+    analyzeActivity(suffix);
+    return suffix;
+}
+
+namespace {
+
+// Appends forward-only nodes and interned constants to a graph
+class GraphBuilder {
+public:
+    explicit GraphBuilder(forge::Graph& graph) : graph_(graph) {
+        for (forge::NodeId id = 0; id < graph_.nodes.size(); ++id) {
+            const forge::Node& node = graph_.nodes[id];
+            if (node.op == forge::OpCode::Constant && !node.isDead) {
+                constants_.emplace(bitsOf(graph_.constPool[static_cast<std::size_t>(node.imm)]), id);
+            }
+        }
+    }
+
+    forge::NodeId op(forge::OpCode code, forge::NodeId a, forge::NodeId b = 0) {
+        forge::Node node;
+        node.op = code;
+        node.a = a;
+        node.b = b;
+        node.c = 0;
+        node.imm = 0.0;
+        node.isActive = true;
+        node.isDead = false;
+        node.needsGradient = false;
+        return append(node);
+    }
+
+    forge::NodeId input() {
+        forge::Node node;
+        node.op = forge::OpCode::Input;
+        node.a = 0;
+        node.b = 0;
+        node.c = 0;
+        node.imm = 0.0;
+        node.isActive = true;
+        node.isDead = false;
+        node.needsGradient = false;
+        return append(node);
+    }
+
+    forge::NodeId constant(double value) {
+        auto it = constants_.find(bitsOf(value));
+        if (it != constants_.end()) {
+            return it->second;
+        }
+        forge::Node node;
+        node.op = forge::OpCode::Constant;
+        node.a = 0;
+        node.b = 0;
+        node.c = 0;
+        node.imm = static_cast<double>(graph_.constPool.size());
+        node.isActive = false;
+        node.isDead = false;
+        node.needsGradient = false;
+        graph_.constPool.push_back(value);
+        forge::NodeId id = append(node);
+        constants_.emplace(bitsOf(value), id);
+        return id;
+    }
+
+    // 1 if x >= 0, else 0: clamp(2 + x * 2^1200, 0, 1). Even a subnormal x
+    // moves 2 + x * 2^1200 past both bounds, so it never ties with a clamp
+    // constant and the step has zero derivative for every double.
+    forge::NodeId step(forge::NodeId x) {
+        const forge::NodeId big = constant(0x1p600);
+        const forge::NodeId scaled = op(forge::OpCode::Mul, op(forge::OpCode::Mul, x, big), big);
+        const forge::NodeId shifted = op(forge::OpCode::Add, constant(2.0), scaled);
+        return op(forge::OpCode::Max, constant(0.0),
+                  op(forge::OpCode::Min, constant(1.0), shifted));
+    }
+
+    // XAD's abs() derivative: +1 if x >= 0, else -1
+    forge::NodeId absDerivative(forge::NodeId x) {
+        return op(forge::OpCode::Sub, op(forge::OpCode::Mul, constant(2.0), step(x)), constant(1.0));
+    }
+
+    // XAD's max/min selection: 1 if a receives the whole derivative (a >= b
+    // for Max, a <= b for Min), 0 if b does
+    forge::NodeId selectsA(forge::OpCode op_code, forge::NodeId a, forge::NodeId b) {
+        return op_code == forge::OpCode::Max ? step(op(forge::OpCode::Sub, a, b))
+                                             : step(op(forge::OpCode::Sub, b, a));
+    }
+
+private:
+    static std::uint64_t bitsOf(double value) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    forge::NodeId append(const forge::Node& node) {
+        forge::NodeId id = static_cast<forge::NodeId>(graph_.nodes.size());
+        graph_.nodes.push_back(node);
+        return id;
+    }
+
+    forge::Graph& graph_;
+    std::unordered_map<std::uint64_t, forge::NodeId> constants_;
+};
+
+} // namespace
+
+TangentGraph makeTangentGraph(const ConversionResult& conversion) {
+    TangentGraph result;
+    result.graph = makePrimalGraph(conversion.graph);
+    forge::Graph& graph = result.graph;
+    const std::size_t num_nodes = graph.nodes.size();
+    GraphBuilder b(graph);
+    using forge::OpCode;
+
+    // tangent[n] == INVALID_NODE means the tangent is identically zero
+    std::vector<forge::NodeId> tangent(num_nodes, INVALID_NODE);
+    for (auto id : conversion.input_nodes) {
+        tangent[id] = b.input();
+        result.input_tangents.push_back(tangent[id]);
+    }
+
+    // a * x where x may be a zero tangent
+    auto scale = [&](forge::NodeId factor, forge::NodeId t) {
+        return t == INVALID_NODE ? INVALID_NODE : b.op(OpCode::Mul, factor, t);
+    };
+    auto add = [&](forge::NodeId x, forge::NodeId y) {
+        if (x == INVALID_NODE) return y;
+        if (y == INVALID_NODE) return x;
+        return b.op(OpCode::Add, x, y);
+    };
+    auto sub = [&](forge::NodeId x, forge::NodeId y) {
+        if (y == INVALID_NODE) return x;
+        if (x == INVALID_NODE) return b.op(OpCode::Neg, y);
+        return b.op(OpCode::Sub, x, y);
+    };
+
+    for (forge::NodeId n = 0; n < num_nodes; ++n) {
+        const forge::Node node = graph.nodes[n];
+        if (node.isDead || node.op == OpCode::Input || node.op == OpCode::Constant) {
+            continue;
+        }
+        const forge::NodeId a = node.a;
+        const forge::NodeId bb = node.b;
+        const forge::NodeId da = tangent[a];
+        const bool binary = node.op == OpCode::Add || node.op == OpCode::Sub ||
+                            node.op == OpCode::Mul || node.op == OpCode::Div ||
+                            node.op == OpCode::Pow || node.op == OpCode::Max ||
+                            node.op == OpCode::Min;
+        const forge::NodeId db = binary ? tangent[bb] : INVALID_NODE;
+        if (da == INVALID_NODE && db == INVALID_NODE) {
+            continue;
+        }
+
+        forge::NodeId t = INVALID_NODE;
+        switch (node.op) {
+            case OpCode::Add: t = add(da, db); break;
+            case OpCode::Sub: t = sub(da, db); break;
+            case OpCode::Mul: t = add(scale(bb, da), scale(a, db)); break;
+            case OpCode::Div:
+                // (da - r * db) / b
+                t = b.op(OpCode::Div, sub(da, scale(n, db)), bb);
+                break;
+            case OpCode::Neg: t = b.op(OpCode::Neg, da); break;
+            case OpCode::Exp: t = scale(n, da); break;
+            case OpCode::Log: t = b.op(OpCode::Div, da, a); break;
+            case OpCode::Sqrt: t = b.op(OpCode::Div, scale(b.constant(0.5), da), n); break;
+            case OpCode::Sin: t = scale(b.op(OpCode::Cos, a), da); break;
+            case OpCode::Cos: t = b.op(OpCode::Neg, scale(b.op(OpCode::Sin, a), da)); break;
+            case OpCode::Tan:
+                t = scale(b.op(OpCode::Add, b.constant(1.0), b.op(OpCode::Square, n)), da);
+                break;
+            case OpCode::Abs: t = scale(b.absDerivative(a), da); break;
+            case OpCode::Square: t = scale(b.op(OpCode::Mul, b.constant(2.0), a), da); break;
+            case OpCode::Recip: t = b.op(OpCode::Neg, scale(b.op(OpCode::Square, n), da)); break;
+            case OpCode::Pow: {
+                // b * a^(b-1) * da + r * log(a) * db
+                forge::NodeId dpow = INVALID_NODE;
+                if (da != INVALID_NODE) {
+                    forge::NodeId exponent = b.op(OpCode::Sub, bb, b.constant(1.0));
+                    dpow = scale(b.op(OpCode::Mul, bb, b.op(OpCode::Pow, a, exponent)), da);
+                }
+                t = add(dpow, scale(b.op(OpCode::Mul, n, b.op(OpCode::Log, a)), db));
+                break;
+            }
+            case OpCode::Max:
+            case OpCode::Min: {
+                // s * da + (1 - s) * db, one masked product per side so the
+                // selected tangent passes through unchanged (no cancellation
+                // against the other one)
+                const forge::NodeId s = b.selectsA(node.op, a, bb);
+                const forge::NodeId not_s = db == INVALID_NODE
+                                                ? INVALID_NODE
+                                                : b.op(OpCode::Sub, b.constant(1.0), s);
+                t = add(scale(s, da), scale(not_s, db));
+                break;
+            }
+            default:
+                throw std::runtime_error("makeTangentGraph: no tangent rule for Forge OpCode=" +
+                                         std::to_string(static_cast<int>(node.op)));
+        }
+        tangent[n] = t;
+    }
+
+    for (auto id : conversion.output_nodes) {
+        forge::NodeId t = tangent[id];
+        if (t == INVALID_NODE) {
+            t = b.constant(0.0);
+        }
+        result.output_tangents.push_back(t);
+        graph.outputs.push_back(t);
+    }
+    return result;
+}
+
+TangentGraph makeHessianGraph(const ConversionResult& conversion) {
+    TangentGraph result = makeTangentGraph(conversion);
+    forge::Graph& graph = result.graph;
+
+    const std::vector<forge::NodeId>& differentiable = conversion.graph.diff_inputs;
+    graph.diff_inputs.clear();
+    for (std::size_t i = 0; i < conversion.input_nodes.size(); ++i) {
+        const forge::NodeId id = conversion.input_nodes[i];
+        if (std::find(differentiable.begin(), differentiable.end(), id) == differentiable.end()) {
+            continue;
+        }
+        graph.diff_inputs.push_back(id);
+        graph.diff_inputs.push_back(result.input_tangents[i]);
+    }
+
+    // Gradient flags for everything between the inputs and the tangents
+    analyzeActivity(graph);
+    return result;
+}
+
+AdjointGraph makeAdjointGraph(const ConversionResult& conversion) {
+    const forge::Graph& primal = conversion.graph;
+    const std::size_t num_nodes = primal.nodes.size();
+
+    AdjointGraph result;
+    forge::Graph& graph = result.graph;
+    graph.constPool = primal.constPool;
+    graph.nodes = primal.nodes;
+    for (auto& node : graph.nodes) {
+        if (!node.isDead && node.op != forge::OpCode::Constant) {
+            node.op = forge::OpCode::Input;
+            node.a = 0;
+            node.b = 0;
+            node.c = 0;
+        }
+        node.needsGradient = false;
+    }
+    GraphBuilder b(graph);
+    using forge::OpCode;
+
+    // adjoint[n] == INVALID_NODE means the adjoint is identically zero
+    std::vector<forge::NodeId> adjoint(num_nodes, INVALID_NODE);
+    auto accumulate = [&](forge::NodeId target, forge::NodeId contribution) {
+        if (contribution == INVALID_NODE || !primal.nodes[target].needsGradient) {
+            return;
+        }
+        adjoint[target] = adjoint[target] == INVALID_NODE
+                              ? contribution
+                              : b.op(OpCode::Add, adjoint[target], contribution);
+    };
+
+    for (auto id : conversion.output_nodes) {
+        const forge::NodeId seed = b.input();
+        result.output_seeds.push_back(seed);
+        accumulate(id, seed);
+    }
+
+    for (forge::NodeId n = static_cast<forge::NodeId>(num_nodes); n-- > 0;) {
+        const forge::Node& node = primal.nodes[n];
+        const forge::NodeId d = adjoint[n];
+        if (node.isDead || d == INVALID_NODE || node.op == OpCode::Input ||
+            node.op == OpCode::Constant) {
+            continue;
+        }
+        const forge::NodeId a = node.a;
+        const forge::NodeId bb = node.b;
+        const bool need_a = primal.nodes[a].needsGradient;
+        auto mul = [&](forge::NodeId x, forge::NodeId y) { return b.op(OpCode::Mul, x, y); };
+
+        switch (node.op) {
+            case OpCode::Add:
+                accumulate(a, d);
+                accumulate(bb, d);
+                break;
+            case OpCode::Sub:
+                accumulate(a, d);
+                if (primal.nodes[bb].needsGradient) {
+                    accumulate(bb, b.op(OpCode::Neg, d));
+                }
+                break;
+            case OpCode::Mul:
+                if (need_a) accumulate(a, mul(d, bb));
+                if (primal.nodes[bb].needsGradient) accumulate(bb, mul(d, a));
+                break;
+            case OpCode::Div: {
+                const forge::NodeId q = b.op(OpCode::Div, d, bb);
+                accumulate(a, q);
+                if (primal.nodes[bb].needsGradient) {
+                    accumulate(bb, b.op(OpCode::Neg, mul(q, n)));
+                }
+                break;
+            }
+            case OpCode::Neg: accumulate(a, b.op(OpCode::Neg, d)); break;
+            case OpCode::Exp: accumulate(a, mul(d, n)); break;
+            case OpCode::Log: accumulate(a, b.op(OpCode::Div, d, a)); break;
+            case OpCode::Sqrt:
+                accumulate(a, b.op(OpCode::Div, mul(b.constant(0.5), d), n));
+                break;
+            case OpCode::Sin: accumulate(a, mul(d, b.op(OpCode::Cos, a))); break;
+            case OpCode::Cos: accumulate(a, b.op(OpCode::Neg, mul(d, b.op(OpCode::Sin, a)))); break;
+            case OpCode::Tan:
+                accumulate(a, mul(d, b.op(OpCode::Add, b.constant(1.0), b.op(OpCode::Square, n))));
+                break;
+            case OpCode::Abs: accumulate(a, mul(d, b.absDerivative(a))); break;
+            case OpCode::Square: accumulate(a, mul(d, mul(b.constant(2.0), a))); break;
+            case OpCode::Recip: accumulate(a, b.op(OpCode::Neg, mul(d, b.op(OpCode::Square, n)))); break;
+            case OpCode::Pow:
+                if (need_a) {
+                    const forge::NodeId exponent = b.op(OpCode::Sub, bb, b.constant(1.0));
+                    accumulate(a, mul(d, mul(bb, b.op(OpCode::Pow, a, exponent))));
+                }
+                if (primal.nodes[bb].needsGradient) {
+                    accumulate(bb, mul(d, mul(n, b.op(OpCode::Log, a))));
+                }
+                break;
+            case OpCode::Max:
+            case OpCode::Min: {
+                // The selected operand gets the whole adjoint, the other none
+                const forge::NodeId to_a = mul(d, b.selectsA(node.op, a, bb));
+                accumulate(a, to_a);
+                if (primal.nodes[bb].needsGradient) {
+                    accumulate(bb, b.op(OpCode::Sub, d, to_a));
+                }
+                break;
+            }
+            default:
+                throw std::runtime_error("makeAdjointGraph: no adjoint rule for Forge OpCode=" +
+                                         std::to_string(static_cast<int>(node.op)));
+        }
+    }
+
+    for (auto id : conversion.input_nodes) {
+        forge::NodeId t = adjoint[id];
+        if (t == INVALID_NODE) {
+            t = b.constant(0.0);
+        }
+        result.input_adjoints.push_back(t);
+        graph.outputs.push_back(t);
+    }
+    return result;
+}
+
+} // namespace forge_xad
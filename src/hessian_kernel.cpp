@@ -0,0 +1,105 @@
+#include "forge_xad/hessian_kernel.hpp"
+#include <compiler/compiler_config.hpp>
+#include <algorithm>
+
+namespace forge_xad {
+
+HessianKernel::HessianKernel(const ConversionResult& conversion)
+    : hessian_(makeHessianGraph(conversion)),
+      input_nodes_(conversion.input_nodes),
+      output_nodes_(conversion.output_nodes) {
+    const std::vector<forge::NodeId>& diff_inputs = conversion.graph.diff_inputs;
+    for (auto id : input_nodes_) {
+        differentiable_.push_back(std::find(diff_inputs.begin(), diff_inputs.end(), id) !=
+                                  diff_inputs.end());
+    }
+
+    forge::CompilerConfig config = forge::CompilerConfig::Default();
+    config.instructionSet = forge::CompilerConfig::InstructionSet::AVX2_PACKED;
+    forge::ForgeEngine engine(config);
+    kernel_ = engine.compile(hessian_.graph);
+}
+
+std::unique_ptr<forge::INodeValueBuffer> HessianKernel::createBuffer() const {
+    return forge::NodeValueBufferFactory::create(hessian_.graph, *kernel_);
+}
+
+void HessianKernel::hessianVectorProducts(forge::INodeValueBuffer& buffer, const double* inputs,
+                                          const double* directions, std::size_t numDirections,
+                                          const double* outputWeights, double* products,
+                                          double* gradient, double* outputs) const {
+    // Lane l of node n lives at index n * LANES + l
+    double* values = buffer.getValuesPtr();
+    double* gradients = buffer.getGradientsPtr();
+    const std::size_t num_inputs = input_nodes_.size();
+    const std::size_t num_outputs = output_nodes_.size();
+
+    for (std::size_t i = 0; i < num_inputs; ++i) {
+        double* dst = values + static_cast<std::size_t>(input_nodes_[i]) * LANES;
+        std::fill(dst, dst + LANES, inputs[i]);
+    }
+
+    // Always run at least once so that outputs and gradient are produced
+    for (std::size_t first = 0; first == 0 || first < numDirections; first += LANES) {
+        const std::size_t count = numDirections > first ? std::min(LANES, numDirections - first) : 0;
+
+        // Unused lanes get a zero direction
+        for (std::size_t i = 0; i < num_inputs; ++i) {
+            double* dst = values + static_cast<std::size_t>(hessian_.input_tangents[i]) * LANES;
+            for (std::size_t lane = 0; lane < LANES; ++lane) {
+                dst[lane] = lane < count ? directions[(first + lane) * num_inputs + i] : 0.0;
+            }
+        }
+
+        // Every lane seeds the output tangents, so the tangent-input
+        // adjoints of any lane hold the gradient
+        if (gradients) {
+            buffer.clearGradients();
+            for (std::size_t j = 0; j < num_outputs; ++j) {
+                const double weight = outputWeights ? outputWeights[j] : 1.0;
+                double* dst = gradients + static_cast<std::size_t>(hessian_.output_tangents[j]) * LANES;
+                for (std::size_t lane = 0; lane < LANES; ++lane) {
+                    dst[lane] += weight;
+                }
+            }
+        }
+
+        kernel_->executeDirect(values, gradients, buffer.getNumNodes());
+
+        for (std::size_t lane = 0; lane < count; ++lane) {
+            double* row = products + (first + lane) * num_inputs;
+            for (std::size_t i = 0; i < num_inputs; ++i) {
+                row[i] = gradients && differentiable_[i]
+                             ? gradients[static_cast<std::size_t>(input_nodes_[i]) * LANES + lane]
+                             : 0.0;
+            }
+        }
+        if (first == 0 && gradient) {
+            for (std::size_t i = 0; i < num_inputs; ++i) {
+                gradient[i] = gradients && differentiable_[i]
+                                  ? gradients[static_cast<std::size_t>(hessian_.input_tangents[i]) * LANES]
+                                  : 0.0;
+            }
+        }
+    }
+
+    if (outputs) {
+        for (std::size_t j = 0; j < num_outputs; ++j) {
+            outputs[j] = values[static_cast<std::size_t>(output_nodes_[j]) * LANES];
+        }
+    }
+}
+
+void HessianKernel::computeHessian(forge::INodeValueBuffer& buffer, const double* inputs,
+                                   const double* outputWeights, double* hessian,
+                                   double* gradient, double* outputs) const {
+    const std::size_t num_inputs = input_nodes_.size();
+    std::vector<double> directions(num_inputs * num_inputs, 0.0);
+    for (std::size_t i = 0; i < num_inputs; ++i) {
+        directions[i * num_inputs + i] = differentiable_[i] ? 1.0 : 0.0;
+    }
+    hessianVectorProducts(buffer, inputs, directions.data(), num_inputs, outputWeights, hessian,
+                          gradient, outputs);
+}
+
+} // namespace forge_xad
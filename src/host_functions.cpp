@@ -0,0 +1,120 @@
+#include "forge_xad/host_functions.hpp"
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace forge_xad {
+
+void HostFunctionRegistry::add(xad::OpCode opcode, HostFunction function) {
+    if (!function.value || !function.partials || function.arity == 0) {
+        throw std::runtime_error("HostFunctionRegistry: host function needs value, partials and arity");
+    }
+    functions_[static_cast<std::uint16_t>(opcode)] = std::move(function);
+}
+
+const HostFunction* HostFunctionRegistry::find(xad::OpCode opcode) const {
+    auto it = functions_.find(static_cast<std::uint16_t>(opcode));
+    return it != functions_.end() ? &it->second : nullptr;
+}
+
+namespace {
+
+// 2 / sqrt(pi); M_2_SQRTPI is not standard C++
+constexpr double kTwoOverSqrtPi = 1.128379167095512574;
+
+HostFunction unary(double (*value)(double), void (*partial)(double x, double result, double* partials)) {
+    HostFunction function;
+    function.arity = 1;
+    function.value = [value](const double* args) { return value(args[0]); };
+    function.partials = [partial](const double* args, double result, double* partials) {
+        partial(args[0], result, partials);
+    };
+    return function;
+}
+
+HostFunctionRegistry makeBuiltins() {
+    HostFunctionRegistry registry;
+    registry.add(xad::OpCode::Erf, unary([](double x) { return std::erf(x); },
+                                         [](double x, double, double* d) {
+                                             d[0] = kTwoOverSqrtPi * std::exp(-x * x);
+                                         }));
+    registry.add(xad::OpCode::Erfc, unary([](double x) { return std::erfc(x); },
+                                          [](double x, double, double* d) {
+                                              d[0] = -kTwoOverSqrtPi * std::exp(-x * x);
+                                          }));
+    registry.add(xad::OpCode::Sinh, unary([](double x) { return std::sinh(x); },
+                                          [](double x, double, double* d) {
+                                              d[0] = std::cosh(x);
+                                          }));
+    registry.add(xad::OpCode::Cosh, unary([](double x) { return std::cosh(x); },
+                                          [](double x, double, double* d) {
+                                              d[0] = std::sinh(x);
+                                          }));
+    registry.add(xad::OpCode::Tanh, unary([](double x) { return std::tanh(x); },
+                                          [](double, double result, double* d) {
+                                              d[0] = 1.0 - result * result;
+                                          }));
+    registry.add(xad::OpCode::Asin, unary([](double x) { return std::asin(x); },
+                                          [](double x, double, double* d) {
+                                              d[0] = 1.0 / std::sqrt(1.0 - x * x);
+                                          }));
+    registry.add(xad::OpCode::Acos, unary([](double x) { return std::acos(x); },
+                                          [](double x, double, double* d) {
+                                              d[0] = -1.0 / std::sqrt(1.0 - x * x);
+                                          }));
+    registry.add(xad::OpCode::Atan, unary([](double x) { return std::atan(x); },
+                                          [](double x, double, double* d) {
+                                              d[0] = 1.0 / (1.0 + x * x);
+                                          }));
+    registry.add(xad::OpCode::Asinh, unary([](double x) { return std::asinh(x); },
+                                           [](double x, double, double* d) {
+                                               d[0] = 1.0 / std::sqrt(x * x + 1.0);
+                                           }));
+    registry.add(xad::OpCode::Acosh, unary([](double x) { return std::acosh(x); },
+                                           [](double x, double, double* d) {
+                                               d[0] = 1.0 / std::sqrt(x * x - 1.0);
+                                           }));
+    registry.add(xad::OpCode::Atanh, unary([](double x) { return std::atanh(x); },
+                                           [](double x, double, double* d) {
+                                               d[0] = 1.0 / (1.0 - x * x);
+                                           }));
+    registry.add(xad::OpCode::Expm1, unary([](double x) { return std::expm1(x); },
+                                           [](double, double result, double* d) {
+                                               d[0] = result + 1.0;
+                                           }));
+    registry.add(xad::OpCode::Log1p, unary([](double x) { return std::log1p(x); },
+                                           [](double x, double, double* d) {
+                                               d[0] = 1.0 / (1.0 + x);
+                                           }));
+
+    HostFunction atan2;
+    atan2.arity = 2;
+    atan2.value = [](const double* args) { return std::atan2(args[0], args[1]); };
+    atan2.partials = [](const double* args, double, double* d) {
+        const double r2 = args[0] * args[0] + args[1] * args[1];
+        d[0] = args[1] / r2;
+        d[1] = -args[0] / r2;
+    };
+    registry.add(xad::OpCode::Atan2, atan2);
+
+    // fmod(a, b) = a - trunc(a / b) b
+    HostFunction fmod;
+    fmod.arity = 2;
+    fmod.value = [](const double* args) { return std::fmod(args[0], args[1]); };
+    fmod.partials = [](const double* args, double, double* d) {
+        d[0] = 1.0;
+        d[1] = -std::trunc(args[0] / args[1]);
+    };
+    registry.add(xad::OpCode::Fmod, fmod);
+    return registry;
+}
+
+} // namespace
+
+std::shared_ptr<const HostFunctionRegistry> builtinHostFunctions() {
+    static const std::shared_ptr<const HostFunctionRegistry> builtins =
+        std::make_shared<const HostFunctionRegistry>(makeBuiltins());
+    return builtins;
+}
+
+} // namespace forge_xad
@@ -0,0 +1,322 @@
+#include "forge_xad/hybrid_kernel.hpp"
+#include "forge_xad/activity_analysis.hpp"
+#include "forge_xad/opcode_traits.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace forge_xad {
+
+namespace {
+
+forge::Node leafNode(forge::OpCode op, bool needsGradient) {
+    forge::Node node;
+    node.op = op;
+    node.a = 0;
+    node.b = 0;
+    node.c = 0;
+    node.imm = 0.0;
+    node.isActive = op == forge::OpCode::Input;
+    node.isDead = false;
+    node.needsGradient = needsGradient;
+    return node;
+}
+
+bool isLeaf(forge::OpCode op) {
+    return op == forge::OpCode::Input || op == forge::OpCode::Constant;
+}
+
+} // namespace
+
+HybridKernel::HybridKernel(const ConversionResult& conversion, const HostFunctionRegistry& functions)
+    : num_nodes_(conversion.graph.nodes.size()),
+      input_nodes_(conversion.input_nodes),
+      output_nodes_(conversion.output_nodes) {
+    const forge::Graph& graph = conversion.graph;
+    const auto& nodes = graph.nodes;
+
+    for (auto id : input_nodes_) {
+        input_differentiable_.push_back(nodes[id].needsGradient);
+    }
+
+    // Stage of every node: host results start a new stage, operations
+    // join the latest stage they read from
+    std::vector<std::size_t> stage(num_nodes_, 0);
+    std::vector<const HostNode*> host_of(num_nodes_, nullptr);
+    for (const HostNode& host : conversion.host_nodes) {
+        host_of[host.result] = &host;
+    }
+    std::size_t num_stages = 1;
+    for (forge::NodeId id = 0; id < num_nodes_; ++id) {
+        const forge::Node& node = nodes[id];
+        if (node.isDead) {
+            continue;
+        }
+        if (const HostNode* host = host_of[id]) {
+            std::size_t operand_stage = 0;
+            for (auto operand : host->operands) {
+                operand_stage = std::max(operand_stage, stage[operand]);
+            }
+            stage[id] = operand_stage + 1;
+        } else if (hasOperandA(node.op)) {
+            stage[id] = stage[node.a];
+            if (hasOperandB(node.op)) {
+                stage[id] = std::max(stage[id], stage[node.b]);
+            }
+        }
+        num_stages = std::max(num_stages, stage[id] + 1);
+    }
+
+    // Operation nodes read outside their own segment become segment outputs
+    std::vector<char> exported(num_nodes_, 0);
+    auto exportNode = [&](forge::NodeId id) {
+        if (!isLeaf(nodes[id].op)) {
+            exported[id] = 1;
+        }
+    };
+    for (auto id : output_nodes_) {
+        exportNode(id);
+    }
+    for (const HostNode& host : conversion.host_nodes) {
+        for (auto operand : host.operands) {
+            exportNode(operand);
+        }
+    }
+    for (forge::NodeId id = 0; id < num_nodes_; ++id) {
+        const forge::Node& node = nodes[id];
+        if (node.isDead || isLeaf(node.op)) {
+            continue;
+        }
+        if (stage[node.a] < stage[id]) {
+            exportNode(node.a);
+        }
+        if (hasOperandB(node.op) && stage[node.b] < stage[id]) {
+            exportNode(node.b);
+        }
+    }
+
+    for (forge::NodeId id = 0; id < num_nodes_; ++id) {
+        if (nodes[id].op == forge::OpCode::Constant && !nodes[id].isDead) {
+            constant_nodes_.push_back(id);
+            constant_values_.push_back(graph.constPool[static_cast<std::size_t>(nodes[id].imm)]);
+        }
+    }
+
+    host_calls_.resize(num_stages);
+    for (const HostNode& host : conversion.host_nodes) {
+        const HostFunction* function = functions.find(host.opcode);
+        if (function == nullptr || function->arity != host.operands.size()) {
+            throw std::runtime_error("HybridKernel: no host function for XAD OpCode=" +
+                                     std::to_string(static_cast<int>(host.opcode)) + " with " +
+                                     std::to_string(host.operands.size()) + " operands");
+        }
+        HostCall call;
+        call.function = *function;
+        call.operands = host.operands;
+        for (auto operand : host.operands) {
+            call.differentiable.push_back(nodes[operand].needsGradient);
+        }
+        call.result = host.result;
+        call.needsGradient = nodes[host.result].needsGradient;
+        host_calls_[stage[host.result]].push_back(std::move(call));
+        ++stats_.hostNodes;
+    }
+
+    // One graph per stage, with its own node IDs
+    segments_.resize(num_stages);
+    std::vector<forge::NodeId> local(num_nodes_, INVALID_NODE);
+    for (std::size_t s = 0; s < num_stages; ++s) {
+        Segment& segment = segments_[s];
+        ConversionResult part;
+        forge::Graph& sub = part.graph;
+        std::vector<forge::NodeId> touched;
+
+        auto bindLeaf = [&](forge::NodeId id) {
+            if (local[id] != INVALID_NODE) {
+                return;
+            }
+            const forge::Node& node = nodes[id];
+            const forge::NodeId local_id = static_cast<forge::NodeId>(sub.nodes.size());
+            if (node.op == forge::OpCode::Constant) {
+                forge::Node constant = leafNode(forge::OpCode::Constant, false);
+                constant.imm = static_cast<double>(sub.constPool.size());
+                sub.constPool.push_back(graph.constPool[static_cast<std::size_t>(node.imm)]);
+                sub.nodes.push_back(constant);
+            } else {
+                // Input, host result or a value of an earlier stage
+                sub.nodes.push_back(leafNode(forge::OpCode::Input, node.needsGradient));
+                part.input_nodes.push_back(local_id);
+                segment.inputs.push_back(id);
+                if (node.needsGradient) {
+                    sub.diff_inputs.push_back(local_id);
+                    segment.differentiable = true;
+                }
+            }
+            local[id] = local_id;
+            touched.push_back(id);
+        };
+        auto isBoundary = [&](forge::NodeId id) {
+            return isLeaf(nodes[id].op) || stage[id] < s;
+        };
+
+        // Leaves first, so that every operation follows its operands
+        std::vector<forge::NodeId> operations;
+        for (forge::NodeId id = 0; id < num_nodes_; ++id) {
+            const forge::Node& node = nodes[id];
+            if (node.isDead || isLeaf(node.op) || stage[id] != s) {
+                continue;
+            }
+            operations.push_back(id);
+            if (isBoundary(node.a)) {
+                bindLeaf(node.a);
+            }
+            if (hasOperandB(node.op) && isBoundary(node.b)) {
+                bindLeaf(node.b);
+            }
+        }
+        for (auto id : operations) {
+            forge::Node node = nodes[id];
+            node.a = local[node.a];
+            if (hasOperandB(node.op)) {
+                node.b = local[node.b];
+            }
+            local[id] = static_cast<forge::NodeId>(sub.nodes.size());
+            touched.push_back(id);
+            sub.nodes.push_back(node);
+            if (exported[id]) {
+                part.output_nodes.push_back(local[id]);
+                sub.outputs.push_back(local[id]);
+                segment.outputs.push_back(id);
+            }
+        }
+
+        for (auto id : touched) {
+            local[id] = INVALID_NODE;
+        }
+        if (operations.empty()) {
+            continue;
+        }
+        analyzeActivity(sub);
+        segment.kernel = std::make_unique<ForwardReverseKernel>(part);
+        stats_.compiledNodes += operations.size();
+        ++stats_.segments;
+    }
+}
+
+HybridKernel::Workspace HybridKernel::createWorkspace() const {
+    Workspace workspace;
+    workspace.values.assign(num_nodes_, 0.0);
+    workspace.adjoints.assign(num_nodes_, 0.0);
+    for (std::size_t k = 0; k < constant_nodes_.size(); ++k) {
+        workspace.values[constant_nodes_[k]] = constant_values_[k];
+    }
+    for (const Segment& segment : segments_) {
+        workspace.buffers.push_back(segment.kernel ? segment.kernel->createBuffer() : nullptr);
+    }
+    return workspace;
+}
+
+void HybridKernel::forward(Workspace& workspace, const double* inputs, double* outputs) const {
+    std::vector<double>& values = workspace.values;
+    std::vector<double>& in = workspace.in;
+    std::vector<double>& out = workspace.out;
+    for (std::size_t i = 0; i < input_nodes_.size(); ++i) {
+        values[input_nodes_[i]] = inputs[i];
+    }
+
+    for (std::size_t s = 0; s < segments_.size(); ++s) {
+        for (const HostCall& call : host_calls_[s]) {
+            in.resize(call.operands.size());
+            for (std::size_t k = 0; k < call.operands.size(); ++k) {
+                in[k] = values[call.operands[k]];
+            }
+            values[call.result] = call.function.value(in.data());
+        }
+
+        const Segment& segment = segments_[s];
+        if (!segment.kernel) {
+            continue;
+        }
+        in.resize(segment.inputs.size());
+        for (std::size_t k = 0; k < segment.inputs.size(); ++k) {
+            in[k] = values[segment.inputs[k]];
+        }
+        out.resize(segment.outputs.size());
+        segment.kernel->forward(*workspace.buffers[s], in.data(), out.data());
+        for (std::size_t j = 0; j < segment.outputs.size(); ++j) {
+            values[segment.outputs[j]] = out[j];
+        }
+    }
+
+    if (outputs) {
+        for (std::size_t j = 0; j < output_nodes_.size(); ++j) {
+            outputs[j] = values[output_nodes_[j]];
+        }
+    }
+}
+
+void HybridKernel::reverse(Workspace& workspace, const double* seeds, double* inputGradients) const {
+    const std::vector<double>& values = workspace.values;
+    std::vector<double>& adjoints = workspace.adjoints;
+    std::vector<double>& in = workspace.in;
+    std::vector<double>& out = workspace.out;
+
+    std::fill(adjoints.begin(), adjoints.end(), 0.0);
+    for (std::size_t j = 0; j < output_nodes_.size(); ++j) {
+        adjoints[output_nodes_[j]] += seeds ? seeds[j] : 1.0;  // outputs may share a node
+    }
+
+    for (std::size_t s = segments_.size(); s-- > 0;) {
+        const Segment& segment = segments_[s];
+        if (segment.kernel && segment.differentiable) {
+            in.resize(segment.outputs.size());
+            for (std::size_t j = 0; j < segment.outputs.size(); ++j) {
+                in[j] = adjoints[segment.outputs[j]];
+            }
+            out.resize(segment.inputs.size());
+            segment.kernel->reverse(*workspace.buffers[s], in.data(), out.data());
+            for (std::size_t k = 0; k < segment.inputs.size(); ++k) {
+                adjoints[segment.inputs[k]] += out[k];
+            }
+        }
+
+        // Host calls of this stage feed only this and later segments, whose
+        // adjoints are complete now
+        for (const HostCall& call : host_calls_[s]) {
+            const double adjoint = adjoints[call.result];
+            if (!call.needsGradient || adjoint == 0.0) {
+                continue;
+            }
+            in.resize(call.operands.size());
+            for (std::size_t k = 0; k < call.operands.size(); ++k) {
+                in[k] = values[call.operands[k]];
+            }
+            out.resize(call.operands.size());
+            call.function.partials(in.data(), values[call.result], out.data());
+            for (std::size_t k = 0; k < call.operands.size(); ++k) {
+                if (call.differentiable[k]) {
+                    adjoints[call.operands[k]] += adjoint * out[k];
+                }
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < input_nodes_.size(); ++i) {
+        inputGradients[i] = input_differentiable_[i] ? adjoints[input_nodes_[i]] : 0.0;
+    }
+}
+
+void HybridKernel::computeAdjointDirections(Workspace& workspace, const double* inputs,
+                                            const double* seeds, std::size_t numDirections,
+                                            double* inputGradients, double* outputs) const {
+    forward(workspace, inputs, outputs);
+    if (!inputGradients) {
+        return;
+    }
+    for (std::size_t d = 0; d < numDirections; ++d) {
+        reverse(workspace, seeds ? seeds + d * numOutputs() : nullptr,
+                inputGradients + d * numInputs());
+    }
+}
+
+} // namespace forge_xad
@@ -0,0 +1,287 @@
+#include "forge_xad/kernel_cache.hpp"
+#include "forge_xad/structural_hash.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace forge_xad {
+
+namespace {
+
+constexpr char MAGIC[4] = {'F', 'X', 'K', 'C'};
+
+struct EntryHeader {
+    char magic[4];
+    std::uint32_t formatVersion;
+    std::uint64_t tapeKey;
+    std::uint64_t tapeCheck;
+    std::uint64_t statements;
+    std::uint64_t operations;
+    std::uint64_t inputs;
+    std::uint64_t outputs;
+    std::uint64_t payloadSize;
+    std::uint64_t payloadChecksum;
+};
+
+// ===== Payload serialization (native byte order, same machine) =====
+
+class Writer {
+public:
+    template<class T>
+    void put(const T& value) {
+        const char* p = reinterpret_cast<const char*>(&value);
+        bytes_.insert(bytes_.end(), p, p + sizeof(T));
+    }
+
+    template<class T>
+    void putVector(const std::vector<T>& values) {
+        put(static_cast<std::uint64_t>(values.size()));
+        for (const auto& v : values) {
+            put(v);
+        }
+    }
+
+    const std::vector<char>& bytes() const { return bytes_; }
+
+private:
+    std::vector<char> bytes_;
+};
+
+class Reader {
+public:
+    Reader(const char* data, std::size_t size) : data_(data), size_(size) {}
+
+    template<class T>
+    bool get(T& value) {
+        if (size_ - pos_ < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data_ + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return true;
+    }
+
+    template<class T>
+    bool getVector(std::vector<T>& values) {
+        std::uint64_t n;
+        if (!get(n) || n > (size_ - pos_) / sizeof(T)) {
+            return false;
+        }
+        values.resize(static_cast<std::size_t>(n));
+        for (auto& v : values) {
+            get(v);
+        }
+        return true;
+    }
+
+    bool atEnd() const { return pos_ == size_; }
+
+private:
+    const char* data_;
+    std::size_t size_;
+    std::size_t pos_ = 0;
+};
+
+std::vector<char> serialize(const ConversionResult& result) {
+    Writer w;
+    const forge::Graph& graph = result.graph;
+
+    w.put(static_cast<std::uint64_t>(graph.nodes.size()));
+    for (const auto& node : graph.nodes) {
+        w.put(static_cast<std::uint16_t>(node.op));
+        w.put(static_cast<std::uint32_t>(node.a));
+        w.put(static_cast<std::uint32_t>(node.b));
+        w.put(static_cast<std::uint32_t>(node.c));
+        w.put(node.imm);
+        const std::uint8_t flags = (node.isActive ? 1 : 0) |
+                                   (node.isDead ? 2 : 0) |
+                                   (node.needsGradient ? 4 : 0);
+        w.put(flags);
+    }
+    w.putVector(graph.constPool);
+    w.putVector(graph.outputs);
+    w.putVector(graph.diff_inputs);
+    w.putVector(result.input_nodes);
+    w.putVector(result.output_nodes);
+
+    w.putVector(result.slot_to_node);
+    w.putVector(result.statement_first_node);
+    w.putVector(result.statement_nodes);
+    return w.bytes();
+}
+
+bool deserialize(const std::vector<char>& bytes, ConversionResult& result) {
+    Reader r(bytes.data(), bytes.size());
+    forge::Graph& graph = result.graph;
+
+    std::uint64_t num_nodes;
+    if (!r.get(num_nodes) || num_nodes > bytes.size()) {
+        return false;
+    }
+    graph.nodes.resize(static_cast<std::size_t>(num_nodes));
+    for (auto& node : graph.nodes) {
+        std::uint16_t op;
+        std::uint32_t a, b, c;
+        std::uint8_t flags;
+        if (!r.get(op) || !r.get(a) || !r.get(b) || !r.get(c) || !r.get(node.imm) || !r.get(flags)) {
+            return false;
+        }
+        node.op = static_cast<forge::OpCode>(op);
+        node.a = static_cast<forge::NodeId>(a);
+        node.b = static_cast<forge::NodeId>(b);
+        node.c = static_cast<forge::NodeId>(c);
+        node.isActive = (flags & 1) != 0;
+        node.isDead = (flags & 2) != 0;
+        node.needsGradient = (flags & 4) != 0;
+    }
+    if (!r.getVector(graph.constPool) || !r.getVector(graph.outputs) ||
+        !r.getVector(graph.diff_inputs) || !r.getVector(result.input_nodes) ||
+        !r.getVector(result.output_nodes) || !r.getVector(result.slot_to_node) ||
+        !r.getVector(result.statement_first_node) || !r.getVector(result.statement_nodes)) {
+        return false;
+    }
+    return r.atEnd();
+}
+
+std::uint64_t checksum(const std::vector<char>& bytes) {
+    StructuralHash h;
+    h.addBytes(bytes.data(), bytes.size());
+    return h.value();
+}
+
+} // namespace
+
+KernelCache::KernelCache(std::string directory) : directory_(std::move(directory)) {
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+    if (ec) {
+        std::cerr << "[KernelCache] Cannot create " << directory_ << ": " << ec.message() << "\n";
+    }
+}
+
+KernelCache::Stats KernelCache::stats() const {
+    Stats stats;
+    stats.hits = hits_.load();
+    stats.misses = misses_.load();
+    stats.rejected = rejected_.load();
+    stats.stores = stores_.load();
+    return stats;
+}
+
+std::string KernelCache::entryPath(std::uint64_t tapeKey) const {
+    std::ostringstream name;
+    name << std::hex;
+    name.width(16);
+    name.fill('0');
+    name << tapeKey << ".fxk";
+    return (std::filesystem::path(directory_) / name.str()).string();
+}
+
+bool KernelCache::load(const TapeFingerprint& fingerprint, ConversionResult& result) {
+    const std::uint64_t tapeKey = fingerprint.key();
+    const std::string path = entryPath(tapeKey);
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        ++misses_;
+        return false;
+    }
+
+    auto reject = [&](const char* reason) {
+        std::cerr << "[KernelCache] Rejecting " << path << ": " << reason << "\n";
+        in.close();
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        ++rejected_;
+        ++misses_;
+        return false;
+    };
+
+    EntryHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        return reject("bad header");
+    }
+    if (header.formatVersion != FORMAT_VERSION) {
+        return reject("stale format version");
+    }
+    if (header.tapeKey != tapeKey) {
+        return reject("key mismatch");
+    }
+    if (header.tapeCheck != fingerprint.check.value() || header.statements != fingerprint.statements ||
+        header.operations != fingerprint.operations || header.inputs != fingerprint.inputs ||
+        header.outputs != fingerprint.outputs) {
+        // A valid entry for another recording with the same key
+        std::cerr << "[KernelCache] Key collision on " << path << ", not using it\n";
+        ++misses_;
+        return false;
+    }
+
+    std::vector<char> payload(static_cast<std::size_t>(header.payloadSize));
+    if (!in.read(payload.data(), static_cast<std::streamsize>(payload.size())) ||
+        in.peek() != std::ifstream::traits_type::eof()) {
+        return reject("truncated or oversized payload");
+    }
+    if (checksum(payload) != header.payloadChecksum) {
+        return reject("checksum mismatch");
+    }
+
+    ConversionResult loaded;
+    if (!deserialize(payload, loaded)) {
+        return reject("malformed payload");
+    }
+
+    result = std::move(loaded);
+    ++hits_;
+    return true;
+}
+
+void KernelCache::store(const TapeFingerprint& fingerprint, const ConversionResult& result) {
+    const std::vector<char> payload = serialize(result);
+
+    EntryHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.formatVersion = FORMAT_VERSION;
+    header.tapeKey = fingerprint.key();
+    header.tapeCheck = fingerprint.check.value();
+    header.statements = fingerprint.statements;
+    header.operations = fingerprint.operations;
+    header.inputs = fingerprint.inputs;
+    header.outputs = fingerprint.outputs;
+    header.payloadSize = payload.size();
+    header.payloadChecksum = checksum(payload);
+
+    const std::string path = entryPath(header.tapeKey);
+    // Unique per writer so concurrent processes never share a temp file
+    std::ostringstream tmp_name;
+    tmp_name << path << ".tmp" << std::hex << std::random_device{}()
+             << std::hash<std::thread::id>{}(std::this_thread::get_id());
+    const std::string tmp_path = tmp_name.str();
+
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+        if (!out) {
+            std::cerr << "[KernelCache] Failed to write " << tmp_path << "\n";
+            std::error_code ec;
+            std::filesystem::remove(tmp_path, ec);
+            return;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+    if (ec) {
+        std::cerr << "[KernelCache] Failed to publish " << path << ": " << ec.message() << "\n";
+        std::filesystem::remove(tmp_path, ec);
+        return;
+    }
+    ++stores_;
+}
+
+} // namespace forge_xad
@@ -0,0 +1,251 @@
+#include "forge_xad/partial_adjoints.hpp"
+#include "forge_xad/graph_transforms.hpp"
+#include "forge_xad/opcode_traits.hpp"
+#include <compiler/compiler_config.hpp>
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace forge_xad {
+
+namespace {
+
+forge::CompilerConfig scalarConfig() {
+    forge::CompilerConfig config = forge::CompilerConfig::Default();
+    config.instructionSet = forge::CompilerConfig::InstructionSet::SSE2_SCALAR;
+    return config;
+}
+
+} // namespace
+
+PartialAdjoints::PartialAdjoints(ConversionResult conversion,
+                                 std::vector<std::uint32_t> inputSlots,
+                                 std::vector<std::uint32_t> statementSlots)
+    : conversion_(std::move(conversion)),
+      input_slots_(std::move(inputSlots)),
+      statement_slots_(std::move(statementSlots)) {
+    if (input_slots_.size() != conversion_.input_nodes.size() ||
+        statement_slots_.size() != conversion_.statement_nodes.size()) {
+        throw std::runtime_error("PartialAdjoints: slot lists do not match the conversion");
+    }
+
+    const forge::Graph primal = makePrimalGraph(conversion_.graph);
+    forge::ForgeEngine engine(scalarConfig());
+    primal_kernel_ = engine.compile(primal);
+    primal_buffer_ = forge::NodeValueBufferFactory::create(primal, *primal_kernel_);
+    host_adjoints_.assign(conversion_.graph.nodes.size(), 0.0);
+}
+
+PartialAdjoints::~PartialAdjoints() = default;
+
+void PartialAdjoints::setMaxPositionKernels(std::size_t count) {
+    max_kernels_ = count > 0 ? count : 1;
+    while (kernels_.size() > max_kernels_) {
+        kernels_.erase(lru_.back());
+        lru_.pop_back();
+    }
+}
+
+PartialAdjoints::PositionKernel& PartialAdjoints::kernelFor(std::size_t position) {
+    auto it = kernels_.find(position);
+    if (it != kernels_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second->lru_position);
+        return *it->second;
+    }
+
+    const forge::Graph& graph = conversion_.graph;
+    const std::size_t num_statements = conversion_.statement_first_node.size();
+    auto pk = std::make_unique<PositionKernel>();
+    pk->boundary = position + 1 < num_statements
+                       ? conversion_.statement_first_node[position + 1]
+                       : static_cast<forge::NodeId>(graph.nodes.size());
+
+    // Slot bindings as of the position. A node can be bound to several
+    // slots (plain copies); its adjoint goes to the slot that bound it
+    // last, which is the named variable rather than a temporary
+    constexpr std::uint32_t NO_SLOT = ~0u;
+    std::vector<forge::NodeId> at_position(numSlots(), INVALID_NODE);
+    std::vector<std::uint32_t> owner(pk->boundary, NO_SLOT);
+    auto bind = [&](std::uint32_t slot, forge::NodeId node) {
+        const forge::NodeId previous = at_position[slot];
+        if (previous != INVALID_NODE && owner[previous] == slot) {
+            owner[previous] = NO_SLOT;
+        }
+        at_position[slot] = node;
+        owner[node] = slot;
+    };
+    for (std::size_t i = 0; i < input_slots_.size(); ++i) {
+        bind(input_slots_[i], conversion_.input_nodes[i]);
+    }
+    for (std::size_t k = 1; k <= position && k < num_statements; ++k) {
+        if (conversion_.statement_nodes[k] != INVALID_NODE) {
+            bind(statement_slots_[k], conversion_.statement_nodes[k]);
+        }
+    }
+    for (std::uint32_t slot = 0; slot < numSlots(); ++slot) {
+        const forge::NodeId node = at_position[slot];
+        if (node != INVALID_NODE && owner[node] == NO_SLOT) {
+            owner[node] = slot;  // previous owner was rebound
+        }
+    }
+
+    for (std::uint32_t slot = 0; slot < numSlots(); ++slot) {
+        const forge::NodeId final_node = conversion_.slot_to_node[slot];
+        if (final_node != INVALID_NODE) {
+            pk->seeds.push_back({slot, final_node});
+        }
+        const forge::NodeId node = at_position[slot];
+        if (node != INVALID_NODE && owner[node] == slot &&
+            graph.nodes[node].op != forge::OpCode::Constant) {
+            pk->results.push_back({slot, node});
+        } else if (final_node != INVALID_NODE || node != INVALID_NODE) {
+            pk->cleared.push_back(slot);
+        }
+    }
+
+    const forge::Graph suffix = makeSuffixGraph(graph, pk->boundary);
+
+    // Prefix nodes the suffix reads need values and may receive adjoints
+    std::vector<char> read(pk->boundary, 0);
+    for (forge::NodeId id = pk->boundary; id < suffix.nodes.size(); ++id) {
+        const forge::Node& node = suffix.nodes[id];
+        if (node.isDead || !hasOperandA(node.op)) {
+            continue;
+        }
+        if (node.a < pk->boundary) {
+            read[node.a] = 1;
+        }
+        if (hasOperandB(node.op) && node.b < pk->boundary) {
+            read[node.b] = 1;
+        }
+    }
+    for (auto id : suffix.diff_inputs) {
+        if (read[id]) {
+            pk->prefix_nodes.push_back(id);
+        }
+    }
+
+    // A result the suffix does not read, seeded only by its own slot,
+    // keeps its adjoint: skip it and its seed. Other prefix seeds only
+    // matter for the result that owns their node.
+    std::vector<std::uint32_t> prefix_seeds(pk->boundary, 0);
+    std::vector<std::uint32_t> seed_slot(pk->boundary, NO_SLOT);
+    for (const auto& seed : pk->seeds) {
+        if (seed.node < pk->boundary) {
+            ++prefix_seeds[seed.node];
+            seed_slot[seed.node] = seed.slot;
+        }
+    }
+    std::vector<char> result_node(pk->boundary, 0);
+    std::vector<SlotNode> results;
+    for (const auto& result : pk->results) {
+        const bool unchanged = !read[result.node] && prefix_seeds[result.node] <= 1 &&
+                               (prefix_seeds[result.node] == 0 || seed_slot[result.node] == result.slot);
+        if (!unchanged) {
+            results.push_back(result);
+            result_node[result.node] = 1;
+        }
+    }
+    pk->results = std::move(results);
+    pk->seeds.erase(std::remove_if(pk->seeds.begin(), pk->seeds.end(),
+                                   [&](const SlotNode& seed) {
+                                       return seed.node < pk->boundary && !result_node[seed.node];
+                                   }),
+                    pk->seeds.end());
+
+    for (const auto& seed : pk->seeds) {
+        pk->touched.push_back(seed.slot);
+    }
+    for (const auto& result : pk->results) {
+        pk->touched.push_back(result.slot);
+    }
+    pk->touched.insert(pk->touched.end(), pk->cleared.begin(), pk->cleared.end());
+    std::sort(pk->touched.begin(), pk->touched.end());
+    pk->touched.erase(std::unique(pk->touched.begin(), pk->touched.end()), pk->touched.end());
+
+    std::cout << "[JITTape] Compiling partial adjoint kernel to position " << position
+              << " (" << graph.nodes.size() - pk->boundary << " of "
+              << graph.nodes.size() << " nodes swept)\n";
+    forge::ForgeEngine engine(scalarConfig());
+    pk->kernel = engine.compile(suffix);
+    pk->buffer = forge::NodeValueBufferFactory::create(suffix, *pk->kernel);
+
+    if (kernels_.size() >= max_kernels_) {
+        kernels_.erase(lru_.back());
+        lru_.pop_back();
+    }
+    lru_.push_front(position);
+    pk->lru_position = lru_.begin();
+    PositionKernel& result = *pk;
+    kernels_.emplace(position, std::move(pk));
+    return result;
+}
+
+const std::vector<std::uint32_t>& PartialAdjoints::touchedSlots(std::size_t position) {
+    return kernelFor(position).touched;
+}
+
+void PartialAdjoints::updatePrimal(const double* inputs) {
+    const std::size_t num_inputs = conversion_.input_nodes.size();
+    if (primal_runs_ > 0 && std::equal(inputs, inputs + num_inputs, primal_inputs_.begin())) {
+        return;
+    }
+    primal_inputs_.assign(inputs, inputs + num_inputs);
+
+    double* primal_values = primal_buffer_->getValuesPtr();
+    for (std::size_t i = 0; i < num_inputs; ++i) {
+        primal_values[conversion_.input_nodes[i]] = inputs[i];
+    }
+    primal_kernel_->executeDirect(primal_values, primal_buffer_->getGradientsPtr(),
+                                  primal_buffer_->getNumNodes());
+    ++primal_runs_;
+}
+
+void PartialAdjoints::computeAdjointsTo(std::size_t position, const double* inputs,
+                                        std::vector<double>& slotAdjoints) {
+    if (slotAdjoints.size() < numSlots()) {
+        throw std::runtime_error("PartialAdjoints: expected " + std::to_string(numSlots()) +
+                                 " slot adjoints, got " + std::to_string(slotAdjoints.size()));
+    }
+    PositionKernel& pk = kernelFor(position);
+
+    // Prefix values from a forward run of the whole graph, redone only
+    // when the inputs changed
+    updatePrimal(inputs);
+    double* values = pk.buffer->getValuesPtr();
+    if (pk.primal_run != primal_runs_) {
+        const double* primal_values = primal_buffer_->getValuesPtr();
+        for (auto node : pk.prefix_nodes) {
+            values[node] = primal_values[node];
+        }
+        pk.primal_run = primal_runs_;
+    }
+
+    // Seeds on suffix nodes go through the kernel; seeds on prefix nodes
+    // pass straight through to the result
+    pk.buffer->clearGradients();
+    double* gradients = pk.buffer->getGradientsPtr();
+    for (const auto& result : pk.results) {
+        host_adjoints_[result.node] = 0.0;
+    }
+    for (const auto& seed : pk.seeds) {
+        const double adjoint = slotAdjoints[seed.slot];
+        if (seed.node >= pk.boundary) {
+            gradients[seed.node] += adjoint;
+        } else {
+            host_adjoints_[seed.node] += adjoint;
+        }
+    }
+
+    pk.kernel->executeDirect(values, gradients, pk.buffer->getNumNodes());
+
+    for (auto slot : pk.cleared) {
+        slotAdjoints[slot] = 0.0;
+    }
+    for (const auto& result : pk.results) {
+        slotAdjoints[result.slot] = gradients[result.node] + host_adjoints_[result.node];
+    }
+}
+
+} // namespace forge_xad
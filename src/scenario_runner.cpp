@@ -0,0 +1,70 @@
+#include "forge_xad/scenario_runner.hpp"
+#include <algorithm>
+
+namespace forge_xad {
+
+ScenarioRunner::ScenarioRunner(const BatchKernel& kernel, unsigned numThreads,
+                               std::size_t chunkSize)
+    : kernel_(kernel),
+      chunk_size_(std::max<std::size_t>(1, (chunkSize + BatchKernel::LANES - 1) / BatchKernel::LANES) *
+                  BatchKernel::LANES),
+      pool_(numThreads) {
+    // One buffer per worker; allocated up front so run() never allocates
+    for (unsigned w = 0; w < pool_.size(); ++w) {
+        buffers_.push_back(kernel_.createBuffer());
+    }
+}
+
+void ScenarioRunner::run(std::size_t numScenarios, const double* inputs, double* outputs,
+                         double* inputGradients, const double* outputSeeds) {
+    pool_.parallelFor(numChunks(numScenarios), [&](unsigned worker, std::size_t chunk) {
+        const std::size_t begin = chunk * chunk_size_;
+        const std::size_t count = std::min(chunk_size_, numScenarios - begin);
+
+        // Offset the base pointers; the stride stays numScenarios
+        kernel_.execute(*buffers_[worker], count, inputs + begin,
+                        outputs ? outputs + begin : nullptr,
+                        inputGradients ? inputGradients + begin : nullptr,
+                        outputSeeds, numScenarios);
+    });
+}
+
+void ScenarioRunner::runReduced(std::size_t numScenarios, const double* inputs,
+                                double* outputSums, double* gradientSums,
+                                const double* outputSeeds) {
+    const std::size_t num_chunks = numChunks(numScenarios);
+    const std::size_t num_outputs = kernel_.numOutputs();
+    const std::size_t num_inputs = kernel_.numInputs();
+    chunk_outputs_.assign(outputSums ? num_chunks * num_outputs : 0, 0.0);
+    chunk_gradients_.assign(gradientSums ? num_chunks * num_inputs : 0, 0.0);
+
+    pool_.parallelFor(num_chunks, [&](unsigned worker, std::size_t chunk) {
+        const std::size_t begin = chunk * chunk_size_;
+        const std::size_t count = std::min(chunk_size_, numScenarios - begin);
+
+        kernel_.executeReduced(*buffers_[worker], count, inputs + begin,
+                               outputSums ? chunk_outputs_.data() + chunk * num_outputs : nullptr,
+                               gradientSums ? chunk_gradients_.data() + chunk * num_inputs : nullptr,
+                               outputSeeds, numScenarios);
+    });
+
+    // Combine the chunk sums in chunk order, whichever worker ran them
+    if (outputSums) {
+        std::fill(outputSums, outputSums + num_outputs, 0.0);
+        for (std::size_t chunk = 0; chunk < num_chunks; ++chunk) {
+            for (std::size_t j = 0; j < num_outputs; ++j) {
+                outputSums[j] += chunk_outputs_[chunk * num_outputs + j];
+            }
+        }
+    }
+    if (gradientSums) {
+        std::fill(gradientSums, gradientSums + num_inputs, 0.0);
+        for (std::size_t chunk = 0; chunk < num_chunks; ++chunk) {
+            for (std::size_t i = 0; i < num_inputs; ++i) {
+                gradientSums[i] += chunk_gradients_[chunk * num_inputs + i];
+            }
+        }
+    }
+}
+
+} // namespace forge_xad
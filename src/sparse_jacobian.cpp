@@ -0,0 +1,101 @@
+#include "forge_xad/sparse_jacobian.hpp"
+#include "forge_xad/opcode_traits.hpp"
+#include <cstdint>
+
+namespace forge_xad {
+
+namespace {
+
+using Word = std::uint64_t;
+constexpr std::size_t WORD_BITS = 64;
+
+} // namespace
+
+JacobianColouring colourJacobian(const ConversionResult& conversion) {
+    const forge::Graph& graph = conversion.graph;
+    JacobianColouring result;
+    result.numOutputs = conversion.output_nodes.size();
+    result.numInputs = conversion.input_nodes.size();
+    const std::size_t words = (result.numInputs + WORD_BITS - 1) / WORD_BITS;
+
+    // Forward sweep: bitset of inputs each node depends on
+    std::vector<Word> depends(graph.nodes.size() * words, 0);
+    for (std::size_t i = 0; i < result.numInputs; ++i) {
+        depends[conversion.input_nodes[i] * words + i / WORD_BITS] |= Word(1) << (i % WORD_BITS);
+    }
+    for (std::size_t n = 0; n < graph.nodes.size(); ++n) {
+        const forge::Node& node = graph.nodes[n];
+        if (node.isDead || !hasOperandA(node.op)) {
+            continue;
+        }
+        Word* dst = &depends[n * words];
+        const Word* a = &depends[static_cast<std::size_t>(node.a) * words];
+        for (std::size_t w = 0; w < words; ++w) {
+            dst[w] |= a[w];
+        }
+        if (hasOperandB(node.op)) {
+            const Word* b = &depends[static_cast<std::size_t>(node.b) * words];
+            for (std::size_t w = 0; w < words; ++w) {
+                dst[w] |= b[w];
+            }
+        }
+    }
+
+    // Pattern rows
+    result.rowOffsets.reserve(result.numOutputs + 1);
+    result.rowOffsets.push_back(0);
+    for (auto output : conversion.output_nodes) {
+        const Word* row = &depends[static_cast<std::size_t>(output) * words];
+        for (std::size_t i = 0; i < result.numInputs; ++i) {
+            if ((row[i / WORD_BITS] >> (i % WORD_BITS)) & 1) {
+                result.columns.push_back(i);
+            }
+        }
+        result.rowOffsets.push_back(result.columns.size());
+    }
+
+    // Greedy colouring: a colour is usable if none of its outputs touch
+    // any input of this output
+    std::vector<Word> colour_inputs;  // [colour][words]
+    result.colours.resize(result.numOutputs);
+    for (std::size_t j = 0; j < result.numOutputs; ++j) {
+        const Word* row = &depends[static_cast<std::size_t>(conversion.output_nodes[j]) * words];
+        std::size_t colour = 0;
+        for (; colour < result.numColours; ++colour) {
+            const Word* used = &colour_inputs[colour * words];
+            bool conflict = false;
+            for (std::size_t w = 0; w < words && !conflict; ++w) {
+                conflict = (used[w] & row[w]) != 0;
+            }
+            if (!conflict) {
+                break;
+            }
+        }
+        if (colour == result.numColours) {
+            ++result.numColours;
+            colour_inputs.resize(result.numColours * words, 0);
+        }
+        Word* used = &colour_inputs[colour * words];
+        for (std::size_t w = 0; w < words; ++w) {
+            used[w] |= row[w];
+        }
+        result.colours[j] = colour;
+    }
+
+    // Outputs grouped by colour
+    result.colourOffsets.assign(result.numColours + 1, 0);
+    for (auto colour : result.colours) {
+        ++result.colourOffsets[colour + 1];
+    }
+    for (std::size_t c = 0; c < result.numColours; ++c) {
+        result.colourOffsets[c + 1] += result.colourOffsets[c];
+    }
+    result.colourOutputs.resize(result.numOutputs);
+    std::vector<std::size_t> fill(result.colourOffsets.begin(), result.colourOffsets.end() - 1);
+    for (std::size_t j = 0; j < result.numOutputs; ++j) {
+        result.colourOutputs[fill[result.colours[j]]++] = j;
+    }
+    return result;
+}
+
+} // namespace forge_xad
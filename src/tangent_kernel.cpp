@@ -0,0 +1,63 @@
+#include "forge_xad/tangent_kernel.hpp"
+#include <compiler/compiler_config.hpp>
+#include <algorithm>
+
+namespace forge_xad {
+
+TangentKernel::TangentKernel(const ConversionResult& conversion)
+    : tangent_(makeTangentGraph(conversion)),
+      input_nodes_(conversion.input_nodes),
+      output_nodes_(conversion.output_nodes) {
+    forge::CompilerConfig config = forge::CompilerConfig::Default();
+    config.instructionSet = forge::CompilerConfig::InstructionSet::AVX2_PACKED;
+    forge::ForgeEngine engine(config);
+    kernel_ = engine.compile(tangent_.graph);
+}
+
+std::unique_ptr<forge::INodeValueBuffer> TangentKernel::createBuffer() const {
+    return forge::NodeValueBufferFactory::create(tangent_.graph, *kernel_);
+}
+
+void TangentKernel::execute(forge::INodeValueBuffer& buffer, const double* inputs,
+                            const double* directions, std::size_t numDirections,
+                            double* outputs, double* outputTangents) const {
+    // Lane l of node n lives at index n * LANES + l
+    double* values = buffer.getValuesPtr();
+    const std::size_t num_inputs = input_nodes_.size();
+    const std::size_t num_outputs = output_nodes_.size();
+
+    for (std::size_t i = 0; i < num_inputs; ++i) {
+        double* dst = values + static_cast<std::size_t>(input_nodes_[i]) * LANES;
+        std::fill(dst, dst + LANES, inputs[i]);
+    }
+
+    // Always run at least once so that outputs are produced
+    for (std::size_t first = 0; first == 0 || first < numDirections; first += LANES) {
+        const std::size_t count = numDirections > first ? std::min(LANES, numDirections - first) : 0;
+
+        // Unused lanes get a zero direction
+        for (std::size_t i = 0; i < num_inputs; ++i) {
+            double* dst = values + static_cast<std::size_t>(tangent_.input_tangents[i]) * LANES;
+            for (std::size_t lane = 0; lane < LANES; ++lane) {
+                dst[lane] = lane < count ? directions[(first + lane) * num_inputs + i] : 0.0;
+            }
+        }
+
+        kernel_->executeDirect(values, buffer.getGradientsPtr(), buffer.getNumNodes());
+
+        for (std::size_t lane = 0; lane < count; ++lane) {
+            double* row = outputTangents + (first + lane) * num_outputs;
+            for (std::size_t j = 0; j < num_outputs; ++j) {
+                row[j] = values[static_cast<std::size_t>(tangent_.output_tangents[j]) * LANES + lane];
+            }
+        }
+    }
+
+    if (outputs) {
+        for (std::size_t j = 0; j < num_outputs; ++j) {
+            outputs[j] = values[static_cast<std::size_t>(output_nodes_[j]) * LANES];
+        }
+    }
+}
+
+} // namespace forge_xad
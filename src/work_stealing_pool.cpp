@@ -0,0 +1,143 @@
+#include "forge_xad/work_stealing_pool.hpp"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace forge_xad {
+
+namespace {
+
+std::uint64_t packRange(std::uint64_t begin, std::uint64_t end) {
+    return begin | (end << 32);
+}
+
+std::size_t rangeBegin(std::uint64_t bounds) {
+    return static_cast<std::size_t>(bounds & 0xffffffffu);
+}
+
+std::size_t rangeEnd(std::uint64_t bounds) {
+    return static_cast<std::size_t>(bounds >> 32);
+}
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(unsigned numThreads) {
+    if (numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < numThreads; ++i) {
+        ranges_.push_back(std::make_unique<Range>());
+    }
+    for (unsigned i = 0; i < numThreads; ++i) {
+        threads_.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::parallelFor(std::size_t numItems, const Task& task) {
+    if (numItems == 0) {
+        return;
+    }
+    if (numItems > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::runtime_error("WorkStealingPool: too many items for one parallelFor()");
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++generation_;
+    task_ = &task;
+    error_ = nullptr;
+    remaining_.store(numItems);
+
+    // Contiguous initial split, one range per worker
+    const std::size_t numWorkers = ranges_.size();
+    for (std::size_t w = 0; w < numWorkers; ++w) {
+        ranges_[w]->bounds.store(packRange(numItems * w / numWorkers, numItems * (w + 1) / numWorkers),
+                                 std::memory_order_relaxed);
+    }
+
+    // No worker of an earlier call is still taking items (busy_ is zero
+    // between calls), and workers only join while task_ is set
+    start_cv_.notify_all();
+    done_cv_.wait(lock, [this] { return remaining_.load() == 0 && busy_ == 0; });
+    task_ = nullptr;
+
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+}
+
+void WorkStealingPool::workerLoop(unsigned index) {
+    std::size_t seen = 0;
+    for (;;) {
+        const Task* task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_cv_.wait(lock, [&] { return stop_ || (generation_ != seen && task_ != nullptr); });
+            if (stop_) {
+                return;
+            }
+            seen = generation_;
+            task = task_;
+            ++busy_;
+        }
+
+        std::size_t item;
+        while (popOrSteal(index, item)) {
+            try {
+                (*task)(index, item);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!error_) {
+                    error_ = std::current_exception();
+                }
+            }
+            remaining_.fetch_sub(1);
+        }
+
+        // All items are taken; the last worker out completes the call
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--busy_ == 0) {
+            done_cv_.notify_all();
+        }
+    }
+}
+
+bool WorkStealingPool::popOrSteal(unsigned index, std::size_t& item) {
+    // Own range first, from the front
+    std::atomic<std::uint64_t>& own = ranges_[index]->bounds;
+    std::uint64_t bounds = own.load(std::memory_order_relaxed);
+    while (rangeBegin(bounds) < rangeEnd(bounds)) {
+        if (own.compare_exchange_weak(bounds, packRange(rangeBegin(bounds) + 1, rangeEnd(bounds)),
+                                      std::memory_order_relaxed)) {
+            item = rangeBegin(bounds);
+            return true;
+        }
+    }
+
+    // Then steal from the back of the other ranges
+    const std::size_t numWorkers = ranges_.size();
+    for (std::size_t k = 1; k < numWorkers; ++k) {
+        std::atomic<std::uint64_t>& victim = ranges_[(index + k) % numWorkers]->bounds;
+        bounds = victim.load(std::memory_order_relaxed);
+        while (rangeBegin(bounds) < rangeEnd(bounds)) {
+            if (victim.compare_exchange_weak(bounds, packRange(rangeBegin(bounds), rangeEnd(bounds) - 1),
+                                             std::memory_order_relaxed)) {
+                item = rangeEnd(bounds) - 1;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+} // namespace forge_xad
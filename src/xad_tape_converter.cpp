@@ -1,79 +1,203 @@
 #include "forge_xad/xad_tape_converter.hpp"
-#include "forge_xad/operation_inference.hpp"
+#include "forge_xad/activity_analysis.hpp"
+#include "forge_xad/opcode_traits.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <stdexcept>
 #include <iostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
 
 namespace forge_xad {
 
+namespace {
+
+// <cmath>'s M_LN10 and M_LN2 are not standard (MSVC needs _USE_MATH_DEFINES)
+constexpr double kLn10 = 2.302585092994045684;
+constexpr double kLn2 = 0.6931471805599453094;
+
+forge::Node makeNode(forge::OpCode op, forge::NodeId a, forge::NodeId b,
+                     bool isActive, bool needsGradient) {
+    forge::Node node;
+    node.op = op;
+    node.a = a;
+    node.b = b;
+    node.c = 0;
+    node.imm = 0.0;
+    node.isActive = isActive;
+    node.isDead = false;
+    node.needsGradient = needsGradient;
+    return node;
+}
+
+forge::NodeId appendNode(forge::Graph& graph, const forge::Node& node) {
+    forge::NodeId node_id = static_cast<forge::NodeId>(graph.nodes.size());
+    graph.nodes.push_back(node);
+    return node_id;
+}
+
+} // namespace
+
 template<class Real, std::size_t N>
-ConversionResult convertXadTapeToForge(const xad::Tape<Real, N>& tape) {
+ConversionResult convertXadTapeToForge(const xad::Tape<Real, N>& tape,
+                                       const ConversionOptions& options) {
     ConversionResult result;
+    forge::Graph& graph = result.graph;
 
-    // Map XAD slot IDs to Forge node IDs
-    std::unordered_map<unsigned int, forge::NodeId> slot_to_node;
-
-    // Step 1: Create input nodes
     const auto& input_slots = tape.getInputSlots();
-    for (auto slot : input_slots) {
-        forge::NodeId node_id = static_cast<forge::NodeId>(result.graph.nodes.size());
-
-        forge::Node input_node;
-        input_node.op = forge::OpCode::Input;
-        input_node.a = 0;
-        input_node.b = 0;
-        input_node.c = 0;
-        input_node.imm = 0.0;
-        input_node.isActive = true;
-        input_node.isDead = false;
-        input_node.needsGradient = true;  // All inputs need gradients for AD
-
-        result.graph.nodes.push_back(input_node);
+    const auto& statements = tape.getStatements();
+    const auto& operations = tape.getOperations();
+    const auto& op_types = tape.getOpTypes();
+
+    // Map XAD slot IDs to Forge node IDs. Slots are dense indices below
+    // getNumVariables(), so a flat table replaces hashing
+    std::vector<forge::NodeId>& slot_to_node = result.slot_to_node;
+    slot_to_node.assign(tape.getNumVariables(), INVALID_NODE);
+
+    // Most statements create one or two nodes (scalar ops add a constant);
+    // lowered math functions create a handful more
+    graph.nodes.reserve(input_slots.size() + 2 * statements.size());
+    result.input_nodes.reserve(input_slots.size());
+    graph.diff_inputs.reserve(input_slots.size());
+
+    auto bindSlot = [&](unsigned int slot, forge::NodeId node_id) {
+        if (slot >= slot_to_node.size()) {
+            slot_to_node.resize(static_cast<std::size_t>(slot) + 1, INVALID_NODE);
+        }
         slot_to_node[slot] = node_id;
+    };
+
+    auto nodeOf = [&](unsigned int slot) {
+        if (slot >= slot_to_node.size() || slot_to_node[slot] == INVALID_NODE) {
+            throw std::runtime_error("XAD tape references slot " + std::to_string(slot) +
+                                     " before it is assigned");
+        }
+        return slot_to_node[slot];
+    };
+
+    // Intern constants by bit pattern: each distinct literal becomes one
+    // Constant node and one pool slot however often it appears
+    std::unordered_map<std::uint64_t, forge::NodeId> constant_nodes;
+    auto internConstant = [&](double value) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        auto it = constant_nodes.find(bits);
+        if (it != constant_nodes.end()) {
+            return it->second;
+        }
+        forge::Node const_node = makeNode(forge::OpCode::Constant, 0, 0, false, false);
+        const_node.imm = static_cast<double>(graph.constPool.size());
+        forge::NodeId const_node_id = appendNode(graph, const_node);
+        graph.constPool.push_back(value);
+        constant_nodes.emplace(bits, const_node_id);
+        return const_node_id;
+    };
+
+    // Appends a supported operation; it needs a gradient if an operand does
+    auto emit = [&](forge::OpCode op, forge::NodeId a, forge::NodeId b = 0) {
+        const bool needs_gradient =
+            graph.nodes[a].needsGradient || (hasOperandB(op) && graph.nodes[b].needsGradient);
+        return appendNode(graph, makeNode(op, a, b, true, needs_gradient));
+    };
+
+    // Math functions Forge has no opcode for, expanded into primitives so
+    // they compile (and differentiate) like any other node. Returns
+    // INVALID_NODE for opcodes without a lowering. The hyperbolic functions
+    // are not lowered: their exp/log forms cancel near 0 (and acosh near 1)
+    // in the value or the adjoint, so they are left to host functions
+    auto lowerMath = [&](xad::OpCode xad_opcode, forge::NodeId x) -> forge::NodeId {
+        using forge::OpCode;
+        switch (xad_opcode) {
+            case xad::OpCode::Log10:
+                return emit(OpCode::Div, emit(OpCode::Log, x), internConstant(kLn10));
+            case xad::OpCode::Log2:
+                return emit(OpCode::Div, emit(OpCode::Log, x), internConstant(kLn2));
+            case xad::OpCode::Exp2:
+                return emit(OpCode::Pow, internConstant(2.0), x);
+            case xad::OpCode::Cbrt: {
+                // sign(x) |x|^(1/3), sign(x) = 2 step(x) - 1 with the step
+                // clamp(2 + x * 2^1200, 0, 1): exact for subnormal x too,
+                // and never tied with a bound, so it has zero derivative
+                const forge::NodeId big = internConstant(0x1p600);
+                const forge::NodeId scaled = emit(OpCode::Mul, emit(OpCode::Mul, x, big), big);
+                const forge::NodeId shifted = emit(OpCode::Add, internConstant(2.0), scaled);
+                const forge::NodeId step = emit(OpCode::Max, internConstant(0.0),
+                                                emit(OpCode::Min, internConstant(1.0), shifted));
+                const forge::NodeId sign =
+                    emit(OpCode::Sub, emit(OpCode::Mul, internConstant(2.0), step), internConstant(1.0));
+                const forge::NodeId abs_x = emit(OpCode::Abs, x);
+                return emit(OpCode::Mul, sign, emit(OpCode::Pow, abs_x, internConstant(1.0 / 3.0)));
+            }
+            default:
+                return INVALID_NODE;
+        }
+    };
+
+    const auto& differentiable = options.differentiableInputs;
+    if (!differentiable.empty() && differentiable.size() != input_slots.size()) {
+        throw std::runtime_error("ConversionOptions: " + std::to_string(differentiable.size()) +
+                                 " differentiable flags for " +
+                                 std::to_string(input_slots.size()) + " inputs");
+    }
+
+    // Step 1: Create input nodes
+    for (std::size_t i = 0; i < input_slots.size(); ++i) {
+        // Inputs need gradients unless registered as value-only
+        const bool needs_gradient = differentiable.empty() || differentiable[i];
+        forge::NodeId node_id =
+            appendNode(graph, makeNode(forge::OpCode::Input, 0, 0, true, needs_gradient));
+        bindSlot(input_slots[i], node_id);
         result.input_nodes.push_back(node_id);
 
         // Mark input for differentiation so buffer allocates gradients
-        result.graph.diff_inputs.push_back(node_id);
+        if (needs_gradient) {
+            graph.diff_inputs.push_back(node_id);
+        }
     }
 
-    // Step 2: Process statements
-    const auto& statements = tape.getStatements();
-    const auto& operations = tape.getOperations();
-    const auto& op_types = tape.getOpTypes();
+    // Position map for partial adjoints: the nodes created by statement k
+    // start at statement_first_node[k], and statement_nodes[k] is the node
+    // its lhs slot is bound to
+    result.statement_first_node.assign(statements.size(), static_cast<forge::NodeId>(graph.nodes.size()));
+    result.statement_nodes.assign(statements.size(), INVALID_NODE);
+    std::size_t stmt_idx = 0;
+    auto bindLhs = [&](unsigned int slot, forge::NodeId node_id) {
+        bindSlot(slot, node_id);
+        result.statement_nodes[stmt_idx] = node_id;
+    };
 
+    // Step 2: Process statements
     // Skip first statement (it's a dummy entry from XAD)
-    for (size_t stmt_idx = 1; stmt_idx < statements.size(); ++stmt_idx) {
-        auto statement = statements[stmt_idx];
-        unsigned int op_end_idx = statement.first;  // Operations END at this statement's index
-        unsigned int lhs_slot = statement.second;
+    for (stmt_idx = 1; stmt_idx < statements.size(); ++stmt_idx) {
+        result.statement_first_node[stmt_idx] = static_cast<forge::NodeId>(graph.nodes.size());
+        const auto statement = statements[stmt_idx];
+        const unsigned int op_end_idx = statement.first;  // Operations END at this statement's index
+        const unsigned int lhs_slot = statement.second;
 
         // Skip invalid statements
         if (lhs_slot == tape.INVALID_SLOT) {
             continue;
         }
 
-        // Operations for this statement are from previous statement to current
-        unsigned int op_start_idx = statements[stmt_idx - 1].first;
+        // Operations for this statement are from previous statement to current,
+        // read in place from the tape
+        const unsigned int op_start_idx = statements[stmt_idx - 1].first;
+        const unsigned int num_operands = op_end_idx - op_start_idx;
 
-        std::vector<OperationInference::Operand> operands;
-        for (unsigned int op_idx = op_start_idx; op_idx < op_end_idx; ++op_idx) {
-            auto op_pair = operations[op_idx];
-            operands.push_back({op_pair.first, op_pair.second});
-        }
-
-        // Skip empty operations (shouldn't happen, but be safe)
-        if (operands.empty()) {
+        // Skip empty operations (input registrations)
+        if (num_operands == 0) {
             continue;
         }
 
         // Get operation type directly from tape (no inference needed!)
-        xad::OpCode xad_opcode = op_types[stmt_idx];
-
-        forge::NodeId result_node_id;
+        const xad::OpCode xad_opcode = op_types[stmt_idx];
 
         // Handle special XAD opcodes that don't map directly to Forge
-        if (xad_opcode == xad::OpCode::Assign && operands.size() == 1) {
+        if (xad_opcode == xad::OpCode::Assign && num_operands == 1) {
             // Assignment: just pass through the existing node
-            slot_to_node[lhs_slot] = slot_to_node[operands[0].slot];
+            bindLhs(lhs_slot, nodeOf(operations[op_start_idx].second));
             continue;
         }
 
@@ -81,72 +205,61 @@ ConversionResult convertXadTapeToForge(const xad::Tape<Real, N>& tape) {
         if ((xad_opcode == xad::OpCode::ScalarMul || xad_opcode == xad::OpCode::ScalarAdd ||
              xad_opcode == xad::OpCode::ScalarSub1 || xad_opcode == xad::OpCode::ScalarSub2 ||
              xad_opcode == xad::OpCode::ScalarDiv1 || xad_opcode == xad::OpCode::ScalarDiv2) &&
-            operands.size() == 1) {
-
-            double scalar_value = operands[0].multiplier;
-            forge::NodeId operand_id = slot_to_node[operands[0].slot];
-
-            // Create constant node for scalar
-            forge::Node const_node;
-            const_node.op = forge::OpCode::Constant;
-            const_node.a = 0;
-            const_node.b = 0;
-            const_node.c = 0;
-            const_node.imm = static_cast<double>(result.graph.constPool.size());
-            const_node.isActive = false;
-            const_node.isDead = false;
-            const_node.needsGradient = false;
-
-            forge::NodeId const_node_id = static_cast<forge::NodeId>(result.graph.nodes.size());
-            result.graph.nodes.push_back(const_node);
-            result.graph.constPool.push_back(scalar_value);
+            num_operands == 1) {
+
+            const auto operation = operations[op_start_idx];
+            const double scalar_value = static_cast<double>(operation.first);
+            const forge::NodeId operand_id = nodeOf(operation.second);
+
+            // Shared constant node for scalar
+            const forge::NodeId const_node_id = internConstant(scalar_value);
 
             // Create binary operation node
-            forge::Node binary_node;
+            forge::OpCode op;
+            forge::NodeId a_id = operand_id;
+            forge::NodeId b_id = const_node_id;
             if (xad_opcode == xad::OpCode::ScalarMul) {
-                binary_node.op = forge::OpCode::Mul;
-                binary_node.a = const_node_id;
-                binary_node.b = operand_id;
+                op = forge::OpCode::Mul;
+                a_id = const_node_id;
+                b_id = operand_id;
             } else if (xad_opcode == xad::OpCode::ScalarAdd) {
-                binary_node.op = forge::OpCode::Add;
-                binary_node.a = operand_id;
-                binary_node.b = const_node_id;
+                op = forge::OpCode::Add;
             } else if (xad_opcode == xad::OpCode::ScalarSub1) {
                 // c - x
-                binary_node.op = forge::OpCode::Sub;
-                binary_node.a = const_node_id;
-                binary_node.b = operand_id;
+                op = forge::OpCode::Sub;
+                a_id = const_node_id;
+                b_id = operand_id;
             } else if (xad_opcode == xad::OpCode::ScalarSub2) {
                 // x - c
-                binary_node.op = forge::OpCode::Sub;
-                binary_node.a = operand_id;
-                binary_node.b = const_node_id;
+                op = forge::OpCode::Sub;
             } else if (xad_opcode == xad::OpCode::ScalarDiv1) {
                 // c / x
-                binary_node.op = forge::OpCode::Div;
-                binary_node.a = const_node_id;
-                binary_node.b = operand_id;
+                op = forge::OpCode::Div;
+                a_id = const_node_id;
+                b_id = operand_id;
             } else { // ScalarDiv2
                 // x / c
-                binary_node.op = forge::OpCode::Div;
-                binary_node.a = operand_id;
-                binary_node.b = const_node_id;
+                op = forge::OpCode::Div;
             }
-            binary_node.c = 0;
-            binary_node.imm = 0.0;
-            binary_node.isActive = true;
-            binary_node.isDead = false;
-            binary_node.needsGradient = result.graph.nodes[operand_id].needsGradient;
 
-            result_node_id = static_cast<forge::NodeId>(result.graph.nodes.size());
-            result.graph.nodes.push_back(binary_node);
+            forge::NodeId result_node_id = appendNode(
+                graph, makeNode(op, a_id, b_id, true, graph.nodes[operand_id].needsGradient));
 
             // Map this slot to the result node
-            slot_to_node[lhs_slot] = result_node_id;
+            bindLhs(lhs_slot, result_node_id);
             continue;
         }
 
-        forge::OpCode opcode = static_cast<forge::OpCode>(static_cast<uint16_t>(xad_opcode));
+        const forge::OpCode opcode = static_cast<forge::OpCode>(static_cast<uint16_t>(xad_opcode));
+        forge::NodeId result_node_id;
+
+        if (num_operands == 1) {
+            result_node_id = lowerMath(xad_opcode, nodeOf(operations[op_start_idx].second));
+            if (result_node_id != INVALID_NODE) {
+                bindLhs(lhs_slot, result_node_id);
+                continue;
+            }
+        }
 
         // Handle different operation types
         if (opcode == forge::OpCode::Neg ||
@@ -157,81 +270,109 @@ ConversionResult convertXadTapeToForge(const xad::Tape<Real, N>& tape) {
             opcode == forge::OpCode::Abs || opcode == forge::OpCode::Square ||
             opcode == forge::OpCode::Recip) {
             // Unary operations
-            forge::NodeId operand_id = slot_to_node[operands[0].slot];
-
-            forge::Node unary_node;
-            unary_node.op = opcode;
-            unary_node.a = operand_id;
-            unary_node.b = 0;
-            unary_node.c = 0;
-            unary_node.imm = 0.0;
-            unary_node.isActive = true;
-            unary_node.isDead = false;
-            // Forward propagation: node needs gradient if operand needs gradient
-            unary_node.needsGradient = result.graph.nodes[operand_id].needsGradient;
+            const forge::NodeId operand_id = nodeOf(operations[op_start_idx].second);
 
-            result_node_id = static_cast<forge::NodeId>(result.graph.nodes.size());
-            result.graph.nodes.push_back(unary_node);
+            // Forward propagation: node needs gradient if operand needs gradient
+            result_node_id = appendNode(
+                graph, makeNode(opcode, operand_id, 0, true, graph.nodes[operand_id].needsGradient));
         }
         else if (opcode == forge::OpCode::Add || opcode == forge::OpCode::Sub ||
                  opcode == forge::OpCode::Mul || opcode == forge::OpCode::Div ||
                  opcode == forge::OpCode::Pow ||
                  opcode == forge::OpCode::Max || opcode == forge::OpCode::Min) {
             // Binary operations
-            if (operands.size() != 2) {
-                std::cerr << "Warning: Binary operation with " << operands.size() << " operands" << std::endl;
+            if (num_operands != 2) {
+                std::cerr << "Warning: Binary operation with " << num_operands << " operands" << std::endl;
                 continue;
             }
 
-            forge::NodeId a_id = slot_to_node[operands[0].slot];
-            forge::NodeId b_id = slot_to_node[operands[1].slot];
-
-            forge::Node binary_node;
-            binary_node.op = opcode;
-            binary_node.a = a_id;
-            binary_node.b = b_id;
-            binary_node.c = 0;
-            binary_node.imm = 0.0;
-            binary_node.isActive = true;
-            binary_node.isDead = false;
-            // Forward propagation: node needs gradient if ANY operand needs gradient
-            binary_node.needsGradient = result.graph.nodes[a_id].needsGradient ||
-                                        result.graph.nodes[b_id].needsGradient;
+            const forge::NodeId a_id = nodeOf(operations[op_start_idx].second);
+            const forge::NodeId b_id = nodeOf(operations[op_start_idx + 1].second);
 
-            result_node_id = static_cast<forge::NodeId>(result.graph.nodes.size());
-            result.graph.nodes.push_back(binary_node);
+            // Forward propagation: node needs gradient if ANY operand needs gradient
+            result_node_id = appendNode(
+                graph, makeNode(opcode, a_id, b_id, true,
+                                graph.nodes[a_id].needsGradient || graph.nodes[b_id].needsGradient));
+        }
+        else if (const HostFunction* host = options.hostFunctions
+                                                ? options.hostFunctions->find(xad_opcode)
+                                                : nullptr;
+                 host != nullptr && host->arity == num_operands) {
+            // Left to the host: the result enters the graph as an input
+            HostNode host_node;
+            host_node.opcode = xad_opcode;
+            bool needs_gradient = false;
+            for (unsigned int k = 0; k < num_operands; ++k) {
+                const forge::NodeId operand_id = nodeOf(operations[op_start_idx + k].second);
+                host_node.operands.push_back(operand_id);
+                graph.outputs.push_back(operand_id);
+                needs_gradient = needs_gradient || graph.nodes[operand_id].needsGradient;
+            }
+            result_node_id =
+                appendNode(graph, makeNode(forge::OpCode::Input, 0, 0, true, needs_gradient));
+            if (needs_gradient) {
+                graph.diff_inputs.push_back(result_node_id);
+            }
+            host_node.result = result_node_id;
+            result.host_nodes.push_back(std::move(host_node));
         }
         else {
             // Unsupported operation - throw exception
             std::string error_msg = "Unsupported XAD operation OpCode=" +
                                   std::to_string(static_cast<int>(xad_opcode)) +
                                   " (Forge OpCode=" + std::to_string(static_cast<int>(opcode)) + ")" +
-                                  " with " + std::to_string(operands.size()) + " operands. " +
+                                  " with " + std::to_string(num_operands) + " operands. " +
                                   "This operation is not yet supported in Forge.";
             throw std::runtime_error(error_msg);
         }
 
         // Map this slot to the result node
-        slot_to_node[lhs_slot] = result_node_id;
+        bindLhs(lhs_slot, result_node_id);
     }
 
     // Step 3: Mark outputs
     const auto& output_slots = tape.getOutputSlots();
+    result.output_nodes.reserve(output_slots.size());
     for (auto slot : output_slots) {
-        if (slot_to_node.find(slot) != slot_to_node.end()) {
+        if (slot < slot_to_node.size() && slot_to_node[slot] != INVALID_NODE) {
             forge::NodeId output_node_id = slot_to_node[slot];
             result.output_nodes.push_back(output_node_id);
-            result.graph.outputs.push_back(output_node_id);
+            graph.outputs.push_back(output_node_id);
         }
     }
 
-    // Store the mapping
-    result.slot_to_node = slot_to_node;
+    // Step 4: Drop work that cannot reach an output (e.g. diagnostics
+    // computed alongside the result)
+    if (options.keepSlotNodes) {
+        for (auto node : slot_to_node) {
+            if (node != INVALID_NODE && graph.nodes[node].op != forge::OpCode::Constant &&
+                graph.nodes[node].op != forge::OpCode::Input) {
+                graph.outputs.push_back(node);
+            }
+        }
+    }
+    analyzeActivity(graph);
 
     return result;
 }
 
-// Explicit template instantiation for common types
-template ConversionResult convertXadTapeToForge<double, 1>(const xad::Tape<double, 1>&);
+// Explicit template instantiation for common types. The recorded
+// statements do not depend on the tape dimension (vector-mode tapes only
+// widen the derivative storage), so all of them convert to the same graph
+template ConversionResult convertXadTapeToForge<double, 1>(const xad::Tape<double, 1>&,
+                                                           const ConversionOptions&);
+template ConversionResult convertXadTapeToForge<double, 2>(const xad::Tape<double, 2>&,
+                                                           const ConversionOptions&);
+template ConversionResult convertXadTapeToForge<double, 4>(const xad::Tape<double, 4>&,
+                                                           const ConversionOptions&);
+template ConversionResult convertXadTapeToForge<double, 8>(const xad::Tape<double, 8>&,
+                                                           const ConversionOptions&);
+template ConversionResult convertXadTapeToForge<double, 16>(const xad::Tape<double, 16>&,
+                                                            const ConversionOptions&);
+
+// Single-precision tapes: recorded constants are widened exactly into the
+// double constant pool and the kernels compute in double
+template ConversionResult convertXadTapeToForge<float, 1>(const xad::Tape<float, 1>&,
+                                                          const ConversionOptions&);
 
 } // namespace forge_xad